@@ -1,7 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <utility>
 #include <vector>
 #include "Event.h"
 
@@ -27,10 +29,18 @@ namespace si
 
 		/// Registers the given event handler, which
 		/// will be called whenever an item is removed
-		/// from this container.
-		void registerRemoveHandler(std::function<void(const std::shared_ptr<T>&)> handler)
+		/// from this container. A token is returned that
+		/// can be used to unregister the handler.
+		EventHandlerToken registerRemoveHandler(std::function<void(const std::shared_ptr<T>&)> handler)
 		{
-			removedEvent.addHandler(handler);
+			return removedEvent.addHandler(handler);
+		}
+
+		/// Unregisters the remove handler that is identified
+		/// by the given token.
+		bool unregisterRemoveHandler(EventHandlerToken token)
+		{
+			return removedEvent.removeHandler(token);
 		}
 
 		/// Tries to remove the given item from this
@@ -53,6 +63,43 @@ namespace si
 			}
 		}
 
+		/// Removes all items from this container that satisfy
+		/// the given predicate, in a single pass. The predicate
+		/// is applied to every item before any remove handlers
+		/// are called. The number of removed items is returned.
+		template<typename TPredicate>
+		std::size_t removeAll(TPredicate predicate)
+		{
+			std::vector<std::shared_ptr<T>> removed;
+			std::size_t keptCount = 0;
+			for (std::size_t i = 0; i < this->items.size(); i++)
+			{
+				if (predicate(this->items[i]))
+				{
+					removed.push_back(std::move(this->items[i]));
+				}
+				else
+				{
+					if (keptCount != i)
+						this->items[keptCount] = std::move(this->items[i]);
+					keptCount++;
+				}
+			}
+			this->items.resize(keptCount);
+
+			for (const auto& item : removed)
+			{
+				removedEvent(item);
+			}
+			return removed.size();
+		}
+
+		/// Gets the number of items in this container.
+		std::size_t size() const
+		{
+			return this->items.size();
+		}
+
 		/// Tests if the given item is currently in
 		/// this container.
 		bool contains(const std::shared_ptr<T>& item) const
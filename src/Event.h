@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <vector>
 
 namespace si
-{	
+{
 	/// Defines a templated event class.
 	/// Events consist of a variable number of
 	/// event handlers, which are called
@@ -14,9 +16,32 @@ namespace si
 	// No generic implementation for Event<F>.
 	// Use specific specializations instead.
 
+	/// Identifies an event handler that has been
+	/// added to an event. Tokens can be used to remove
+	/// the handler from the event later on.
+	struct EventHandlerToken
+	{
+		/// The index of the handler's slot.
+		std::size_t slot;
+
+		/// The slot's generation at the time the handler
+		/// was added. A slot's generation is incremented
+		/// whenever its handler is removed, which makes
+		/// stale tokens harmless.
+		std::size_t generation;
+	};
+
 	/// Defines a base class for event handlers,
 	/// which supports creating a list of handlers, but
 	/// not calling them.
+	///
+	/// Handlers are stored in stable slots. The first slot
+	/// is stored inline, so events that have a single handler
+	/// never allocate. Handlers that are added while the event
+	/// is being raised are not invoked until the next time the
+	/// event is raised. Handlers that are removed while the event
+	/// is being raised are no longer invoked, but their slots are
+	/// only recycled once the event is no longer being raised.
 	template<typename TRet, typename... TArgs>
 	class EventBase
 	{
@@ -24,13 +49,149 @@ namespace si
 		/// Defines a type for event handler functions.
 		typedef std::function<TRet(TArgs...)> EventHandler;
 
+		/// Creates an event that has no handlers.
+		EventBase()
+			: firstSlot(), extraSlots(), freeSlots(), pendingRemovals(),
+			  slotCount(0), handlerCount(0), dispatchDepth(0)
+		{ }
+
 		/// Adds a handler to this event's list of handlers.
-		void addHandler(const EventHandler& handler)
+		/// A token is returned that can be used to remove
+		/// the handler.
+		EventHandlerToken addHandler(const EventHandler& handler)
+		{
+			std::size_t index;
+			if (this->dispatchDepth == 0 && !this->freeSlots.empty())
+			{
+				// Recycle a free slot. This is never done while
+				// the event is being raised, because the slot's
+				// old handler might still be executing.
+				index = this->freeSlots.back();
+				this->freeSlots.pop_back();
+			}
+			else
+			{
+				// Create a new slot. The extra slots are stored
+				// in a deque, so creating a new slot does not
+				// move any handlers that may be executing.
+				index = this->slotCount;
+				if (index > 0)
+					this->extraSlots.emplace_back();
+				this->slotCount++;
+			}
+
+			auto& slot = this->getSlot(index);
+			slot.handler = handler;
+			slot.isActive = true;
+			this->handlerCount++;
+			return EventHandlerToken { index, slot.generation };
+		}
+
+		/// Removes the handler that is identified by the
+		/// given token from this event. A boolean is returned
+		/// that tells if the handler was removed. Removing a
+		/// handler that has already been removed has no effect.
+		bool removeHandler(EventHandlerToken token)
 		{
-			this->handlers.push_back(handler);
+			if (token.slot >= this->slotCount)
+				return false;
+
+			auto& slot = this->getSlot(token.slot);
+			if (!slot.isActive || slot.generation != token.generation)
+				return false;
+
+			slot.isActive = false;
+			slot.generation++;
+			this->handlerCount--;
+
+			if (this->dispatchDepth == 0)
+				this->releaseSlot(token.slot);
+			else
+				this->pendingRemovals.push_back(token.slot);
+
+			return true;
 		}
+
+		/// Gets the number of handlers that are registered
+		/// with this event.
+		std::size_t getHandlerCount() const
+		{
+			return this->handlerCount;
+		}
+
 	protected:
-		std::vector<EventHandler> handlers;
+		/// Describes a slot that can hold an event handler.
+		struct HandlerSlot
+		{
+			HandlerSlot()
+				: handler(), generation(0), isActive(false)
+			{ }
+
+			EventHandler handler;
+			std::size_t generation;
+			bool isActive;
+		};
+
+		/// Marks the event as being raised for as long as
+		/// this object is alive.
+		class DispatchScope final
+		{
+		public:
+			DispatchScope(EventBase& owner)
+				: owner(owner)
+			{
+				owner.dispatchDepth++;
+			}
+
+			DispatchScope(const DispatchScope&) = delete;
+
+			~DispatchScope()
+			{
+				owner.dispatchDepth--;
+				if (owner.dispatchDepth == 0)
+				{
+					// Now that no handlers are executing anymore,
+					// the slots of removed handlers can be recycled.
+					for (auto index : owner.pendingRemovals)
+						owner.releaseSlot(index);
+					owner.pendingRemovals.clear();
+				}
+			}
+
+		private:
+			EventBase& owner;
+		};
+
+		/// Gets the number of slots in this event. Handlers
+		/// that are added while the event is being raised
+		/// are stored in slots beyond this number.
+		std::size_t getSlotCount() const
+		{
+			return this->slotCount;
+		}
+
+		/// Gets the slot with the given index.
+		HandlerSlot& getSlot(std::size_t index)
+		{
+			return index == 0 ? this->firstSlot : this->extraSlots[index - 1];
+		}
+
+	private:
+		/// Destroys the given slot's handler, and adds the
+		/// slot to the free list.
+		void releaseSlot(std::size_t index)
+		{
+			this->getSlot(index).handler = nullptr;
+			this->freeSlots.push_back(index);
+		}
+
+		HandlerSlot firstSlot;
+		std::deque<HandlerSlot> extraSlots;
+		std::vector<std::size_t> freeSlots;
+		std::vector<std::size_t> pendingRemovals;
+		std::size_t slotCount;
+		std::size_t handlerCount;
+		std::size_t dispatchDepth;
 	};
 
 	/// Defines a templated event class.
@@ -46,17 +207,19 @@ namespace si
 		/// return value is returned.
 		TRet operator()(TArgs... args)
 		{
-			// Copy the handler vector.
-			// Since function calls can do just about 
-			// anything, we need to make sure that they 
-			// do not in any way modify the handler list,
-			// as this could corrupt the iterators
-			// we're using in the for loop below.
-			auto copy = this->handlers;
-			TRet result;
-			for (const auto& item : copy)
+			typename EventBase<TRet, TArgs...>::DispatchScope scope(*this);
+
+			// Only the handlers that are registered right now
+			// are invoked. Handlers may add or remove handlers,
+			// but slots are never moved or recycled while the
+			// event is being raised.
+			TRet result = TRet();
+			std::size_t count = this->getSlotCount();
+			for (std::size_t i = 0; i < count; i++)
 			{
-				result = item(args...);
+				auto& slot = this->getSlot(i);
+				if (slot.isActive)
+					result = slot.handler(args...);
 			}
 			return result;
 		}
@@ -74,17 +237,19 @@ namespace si
 		/// notified.
 		void operator()(TArgs... args)
 		{
-			// Copy the handler vector.
-			// Since function calls can do just about 
-			// anything, we need to make sure that they 
-			// do not in any way modify the handler list,
-			// as this could corrupt the iterators
-			// we're using in the for loop below.
-			auto copy = this->handlers;
-			for (const auto& item : copy)
+			typename EventBase<void, TArgs...>::DispatchScope scope(*this);
+
+			// Only the handlers that are registered right now
+			// are invoked. Handlers may add or remove handlers,
+			// but slots are never moved or recycled while the
+			// event is being raised.
+			std::size_t count = this->getSlotCount();
+			for (std::size_t i = 0; i < count; i++)
 			{
-				item(args...);
+				auto& slot = this->getSlot(i);
+				if (slot.isActive)
+					slot.handler(args...);
 			}
 		}
 	};
-}
\ No newline at end of file
+}
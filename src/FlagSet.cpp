@@ -0,0 +1,70 @@
+#include "FlagSet.h"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace si;
+
+/// Creates an empty flag set.
+FlagSet::FlagSet()
+	: ids(), values(), changeCounts()
+{ }
+
+/// Gets the identifier of the flag with the given
+/// name. If no such flag exists yet, then it is
+/// created and initialized to false.
+FlagId FlagSet::intern(const std::string& name)
+{
+	auto result = this->ids.insert(std::make_pair(name, this->values.size()));
+	if (result.second)
+	{
+		// We just created a new flag.
+		this->values.push_back(false);
+		this->changeCounts.push_back(0);
+	}
+	return result.first->second;
+}
+
+/// Tries to find the identifier of the flag with
+/// the given name.
+bool FlagSet::tryGetId(const std::string& name, FlagId& result) const
+{
+	auto pos = this->ids.find(name);
+	if (pos == this->ids.end())
+		return false;
+
+	result = pos->second;
+	return true;
+}
+
+/// Gets the value of the flag with the given identifier.
+bool FlagSet::get(FlagId id) const
+{
+	return this->values[id];
+}
+
+/// Sets the flag with the given identifier to the given value.
+void FlagSet::set(FlagId id, bool value)
+{
+	if (this->values[id] != value)
+	{
+		this->values[id] = value;
+		this->changeCounts[id]++;
+	}
+}
+
+/// Gets the number of times that the value of the flag with the
+/// given identifier has flipped.
+std::size_t FlagSet::getChangeCount(FlagId id) const
+{
+	return this->changeCounts[id];
+}
+
+/// Gets the number of flags in this flag set.
+std::size_t FlagSet::size() const
+{
+	return this->values.size();
+}
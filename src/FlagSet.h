@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace si
+{
+	/// A dense integer identifier for a named boolean flag.
+	typedef std::size_t FlagId;
+
+	/// Defines a set of named boolean flags. Flag names are
+	/// interned to dense integer identifiers, which index a
+	/// bitset. Every flag also has a change counter, which
+	/// is incremented whenever the flag's value flips. This
+	/// allows observers to check cheaply if a flag has changed.
+	class FlagSet final
+	{
+	public:
+		/// Creates an empty flag set.
+		FlagSet();
+
+		/// Gets the identifier of the flag with the given
+		/// name. If no such flag exists yet, then it is
+		/// created and initialized to false.
+		FlagId intern(const std::string& name);
+
+		/// Tries to find the identifier of the flag with
+		/// the given name. A boolean is returned that tells
+		/// if the flag was found.
+		bool tryGetId(const std::string& name, FlagId& result) const;
+
+		/// Gets the value of the flag with the given identifier.
+		bool get(FlagId id) const;
+
+		/// Sets the flag with the given identifier to the given value.
+		void set(FlagId id, bool value);
+
+		/// Gets the number of times that the value of the flag with the
+		/// given identifier has flipped.
+		std::size_t getChangeCount(FlagId id) const;
+
+		/// Gets the number of flags in this flag set.
+		std::size_t size() const;
+
+	private:
+		std::unordered_map<std::string, FlagId> ids;
+		std::vector<bool> values;
+		std::vector<std::size_t> changeCounts;
+	};
+}
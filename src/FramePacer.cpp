@@ -0,0 +1,114 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include "Common.h"
+
+using namespace si;
+
+const duration_t FramePacer::SpinTime = duration_t(0.002);
+
+/// Creates a frame pacer that starts a frame every
+/// given period.
+FramePacer::FramePacer(duration_t framePeriod)
+	: framePeriod(framePeriod), deadline(), frameStart(),
+	  frameCount(0), frameTimeSum(0.0), frameTimeSquareSum(0.0), maxFrameTime(0.0)
+{
+	this->reset();
+}
+
+/// Gets the amount of time between the starts of
+/// two consecutive frames.
+duration_t FramePacer::getFramePeriod() const
+{
+	return this->framePeriod;
+}
+
+/// Sets the amount of time between the starts of
+/// two consecutive frames.
+void FramePacer::setFramePeriod(duration_t framePeriod)
+{
+	this->framePeriod = framePeriod;
+	this->reset();
+}
+
+/// Waits until the next frame is due, and records
+/// the current frame's duration.
+void FramePacer::wait()
+{
+	auto now = clock_t::now();
+	if (this->framePeriod.count() > 0.0)
+	{
+		// Sleep through most of the remaining time, and spin
+		// for the last bit of it. Sleeping is cheap, but it
+		// can overshoot by a scheduler time slice or so.
+		auto spinStart = this->deadline - std::chrono::duration_cast<clock_t::duration>(SpinTime);
+		if (now < spinStart)
+			std::this_thread::sleep_until(spinStart);
+
+		now = clock_t::now();
+		while (now < this->deadline)
+		{
+			now = clock_t::now();
+		}
+
+		auto period = std::chrono::duration_cast<clock_t::duration>(this->framePeriod);
+		this->deadline += period;
+		if (this->deadline < now)
+		{
+			// We've fallen behind by more than a frame. Don't try
+			// to catch up by rushing through frames.
+			this->deadline = now + period;
+		}
+	}
+
+	double frameTime = duration_t(now - this->frameStart).count();
+	this->frameStart = now;
+	this->frameCount++;
+	this->frameTimeSum += frameTime;
+	this->frameTimeSquareSum += frameTime * frameTime;
+	this->maxFrameTime = std::max(this->maxFrameTime, frameTime);
+}
+
+/// Makes the next frame due one frame period from now,
+/// without recording a frame.
+void FramePacer::reset()
+{
+	this->frameStart = clock_t::now();
+	this->deadline = this->frameStart + std::chrono::duration_cast<clock_t::duration>(this->framePeriod);
+}
+
+/// Gets the number of frames that have been measured.
+std::size_t FramePacer::getFrameCount() const
+{
+	return this->frameCount;
+}
+
+/// Gets the average duration of a frame.
+duration_t FramePacer::getMeanFrameTime() const
+{
+	if (this->frameCount == 0)
+		return duration_t(0.0);
+
+	return duration_t(this->frameTimeSum / this->frameCount);
+}
+
+/// Gets the standard deviation of the frames' durations.
+duration_t FramePacer::getJitter() const
+{
+	if (this->frameCount == 0)
+		return duration_t(0.0);
+
+	double mean = this->frameTimeSum / this->frameCount;
+	double variance = this->frameTimeSquareSum / this->frameCount - mean * mean;
+	return duration_t(std::sqrt(std::max(variance, 0.0)));
+}
+
+/// Gets the duration of the longest frame.
+duration_t FramePacer::getMaxFrameTime() const
+{
+	return duration_t(this->maxFrameTime);
+}
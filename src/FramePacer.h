@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include "Common.h"
+
+namespace si
+{
+	/// Defines a frame pacer, which makes frames start at
+	/// regular intervals. Rather than spinning until the next
+	/// frame is due, the frame pacer sleeps until shortly before
+	/// the frame's deadline, and then spins for the remaining
+	/// time, which the operating system's scheduler can't be
+	/// trusted to get right.
+	///
+	/// The frame pacer also measures how long frames take,
+	/// so the pacing's jitter can be reported.
+	class FramePacer final
+	{
+	public:
+		/// Creates a frame pacer that starts a frame every
+		/// given period. A period of zero means that the
+		/// frame pacer does not wait at all; it then only
+		/// measures frame times.
+		FramePacer(duration_t framePeriod);
+
+		/// Gets the amount of time between the starts of
+		/// two consecutive frames.
+		duration_t getFramePeriod() const;
+
+		/// Sets the amount of time between the starts of
+		/// two consecutive frames.
+		void setFramePeriod(duration_t framePeriod);
+
+		/// Waits until the next frame is due, and records
+		/// the current frame's duration.
+		void wait();
+
+		/// Makes the next frame due one frame period from now,
+		/// without recording a frame. This should be called after
+		/// an operation that stalls the game, like loading a scene.
+		void reset();
+
+		/// Gets the number of frames that have been measured.
+		std::size_t getFrameCount() const;
+
+		/// Gets the average duration of a frame.
+		duration_t getMeanFrameTime() const;
+
+		/// Gets the standard deviation of the frames' durations:
+		/// the frame pacing's jitter.
+		duration_t getJitter() const;
+
+		/// Gets the duration of the longest frame.
+		duration_t getMaxFrameTime() const;
+
+		/// The amount of time before a deadline at which the
+		/// frame pacer stops sleeping, and starts spinning.
+		static const duration_t SpinTime;
+
+	private:
+		typedef std::chrono::steady_clock clock_t;
+
+		duration_t framePeriod;
+		clock_t::time_point deadline;
+		clock_t::time_point frameStart;
+
+		std::size_t frameCount;
+		double frameTimeSum;
+		double frameTimeSquareSum;
+		double maxFrameTime;
+	};
+}
@@ -0,0 +1,83 @@
+#include "InputMapper.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include "InputState.h"
+#include "KeyBindings.h"
+
+using namespace si;
+
+/// Creates an input mapper that uses the given key bindings.
+InputMapper::InputMapper(const KeyBindings& bindings)
+	: bindings(bindings), heldKeys(), heldKeyCounts(), pressedActions(0)
+{ }
+
+/// Replaces this input mapper's key bindings.
+void InputMapper::setBindings(const KeyBindings& bindings)
+{
+	this->bindings = bindings;
+	this->releaseAll();
+}
+
+/// Handles the given window event.
+void InputMapper::handleEvent(const sf::Event& event)
+{
+	switch (event.type)
+	{
+	case sf::Event::KeyPressed:
+	case sf::Event::KeyReleased:
+	{
+		auto key = event.key.code;
+		bool isPressed = event.type == sf::Event::KeyPressed;
+		PlayerAction action;
+		// Key repeat events are ignored, and so are
+		// releases of keys that were never pressed.
+		if (!this->bindings.tryGetAction(key, action) || this->heldKeys[key] == isPressed)
+			break;
+
+		this->heldKeys[key] = isPressed;
+		int index = static_cast<int>(action);
+		if (isPressed)
+		{
+			this->heldKeyCounts[index]++;
+			this->pressedActions |= static_cast<std::uint8_t>(1 << index);
+		}
+		else
+		{
+			this->heldKeyCounts[index]--;
+		}
+		break;
+	}
+	case sf::Event::LostFocus:
+		// Key releases aren't reported to windows that
+		// don't have focus.
+		this->releaseAll();
+		break;
+	default:
+		break;
+	}
+}
+
+/// Gets the input state for the frame that has just ended,
+/// and starts a new frame.
+InputState InputMapper::nextFrame()
+{
+	InputState result(this->pressedActions);
+	for (std::size_t i = 0; i < this->heldKeyCounts.size(); i++)
+	{
+		if (this->heldKeyCounts[i] > 0)
+			result.setActive(static_cast<PlayerAction>(i), true);
+	}
+	this->pressedActions = 0;
+	return result;
+}
+
+/// Releases all keys.
+void InputMapper::releaseAll()
+{
+	this->heldKeys.fill(false);
+	this->heldKeyCounts.fill(0);
+}
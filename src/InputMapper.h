@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include "InputState.h"
+#include "KeyBindings.h"
+
+namespace si
+{
+	/// Defines an input mapper, which turns a window's key
+	/// events into player actions. Events are handled as they
+	/// are polled from the window, so the keyboard never has
+	/// to be polled.
+	class InputMapper final
+	{
+	public:
+		/// Creates an input mapper that uses the given key bindings.
+		InputMapper(const KeyBindings& bindings);
+
+		/// Replaces this input mapper's key bindings. All keys
+		/// are considered to be released.
+		void setBindings(const KeyBindings& bindings);
+
+		/// Handles the given window event. Events other than
+		/// key presses, key releases and focus loss are ignored.
+		void handleEvent(const sf::Event& event);
+
+		/// Gets the input state for the frame that has just ended,
+		/// and starts a new frame. An action is active if one of its
+		/// keys is being held, or if one of its keys was pressed
+		/// during the frame, even if it was released right away.
+		InputState nextFrame();
+
+	private:
+		/// Releases all keys.
+		void releaseAll();
+
+		KeyBindings bindings;
+
+		/// Tells which keys are being held.
+		std::array<bool, sf::Keyboard::KeyCount> heldKeys;
+
+		/// The number of keys that are being held for every action.
+		/// There is a counter for every bit in an input state.
+		std::array<int, 8> heldKeyCounts;
+
+		/// The actions whose keys have been pressed during the
+		/// current frame, as a bit mask.
+		std::uint8_t pressedActions;
+	};
+}
@@ -0,0 +1,47 @@
+#include "InputState.h"
+
+#include <cstdint>
+
+using namespace si;
+
+/// Creates an input state in which no actions are active.
+InputState::InputState()
+	: bits(0)
+{ }
+
+/// Creates an input state from the given bit mask.
+InputState::InputState(std::uint8_t bits)
+	: bits(bits)
+{ }
+
+/// Tests if the given action is active.
+bool InputState::isActive(PlayerAction action) const
+{
+	return (this->bits >> static_cast<int>(action)) & 1;
+}
+
+/// Sets the given action's state.
+void InputState::setActive(PlayerAction action, bool isActive)
+{
+	auto mask = static_cast<std::uint8_t>(1 << static_cast<int>(action));
+	if (isActive)
+		this->bits |= mask;
+	else
+		this->bits &= static_cast<std::uint8_t>(~mask);
+}
+
+/// Gets this input state as a bit mask.
+std::uint8_t InputState::getBits() const
+{
+	return this->bits;
+}
+
+bool InputState::operator==(const InputState& other) const
+{
+	return this->bits == other.bits;
+}
+
+bool InputState::operator!=(const InputState& other) const
+{
+	return !(*this == other);
+}
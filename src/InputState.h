@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace si
+{
+	/// Enumerates the actions that a player can perform.
+	enum class PlayerAction : std::uint8_t
+	{
+		Forward,
+		Backward,
+		Left,
+		Right,
+		Fire
+	};
+
+	/// Describes which player actions are active during a
+	/// frame. Input is sampled once per frame, and controllers
+	/// read it from the scene, rather than polling the keyboard
+	/// themselves. This allows input to be recorded and replayed.
+	class InputState final
+	{
+	public:
+		/// Creates an input state in which no actions are active.
+		InputState();
+
+		/// Creates an input state from the given bit mask, in
+		/// which every bit corresponds to a player action.
+		explicit InputState(std::uint8_t bits);
+
+		/// Tests if the given action is active.
+		bool isActive(PlayerAction action) const;
+
+		/// Sets the given action's state.
+		void setActive(PlayerAction action, bool isActive);
+
+		/// Gets this input state as a bit mask, in which every
+		/// bit corresponds to a player action.
+		std::uint8_t getBits() const;
+
+		bool operator==(const InputState& other) const;
+		bool operator!=(const InputState& other) const;
+
+	private:
+		std::uint8_t bits;
+	};
+}
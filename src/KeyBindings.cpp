@@ -0,0 +1,102 @@
+#include "KeyBindings.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <SFML/Window/Keyboard.hpp>
+#include "InputState.h"
+
+using namespace si;
+
+namespace
+{
+	/// The names of all keys, in the order of the
+	/// sf::Keyboard::Key enumeration.
+	const char* const KeyNames[sf::Keyboard::KeyCount] =
+	{
+		"A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N", "O",
+		"P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "Num0", "Num1",
+		"Num2", "Num3", "Num4", "Num5", "Num6", "Num7", "Num8", "Num9", "Escape",
+		"LControl", "LShift", "LAlt", "LSystem", "RControl", "RShift", "RAlt",
+		"RSystem", "Menu", "LBracket", "RBracket", "SemiColon", "Comma", "Period",
+		"Quote", "Slash", "BackSlash", "Tilde", "Equal", "Dash", "Space", "Return",
+		"BackSpace", "Tab", "PageUp", "PageDown", "End", "Home", "Insert", "Delete",
+		"Add", "Subtract", "Multiply", "Divide", "Left", "Right", "Up", "Down",
+		"Numpad0", "Numpad1", "Numpad2", "Numpad3", "Numpad4", "Numpad5", "Numpad6",
+		"Numpad7", "Numpad8", "Numpad9", "F1", "F2", "F3", "F4", "F5", "F6", "F7",
+		"F8", "F9", "F10", "F11", "F12", "F13", "F14", "F15", "Pause"
+	};
+
+	/// The names of all player actions, in the order of
+	/// the PlayerAction enumeration.
+	const char* const ActionNames[] =
+	{
+		"forward", "backward", "left", "right", "fire"
+	};
+}
+
+/// Creates a set of key bindings in which no keys are bound.
+KeyBindings::KeyBindings()
+	: actions()
+{ }
+
+/// Gets the default key bindings.
+KeyBindings KeyBindings::getDefault()
+{
+	KeyBindings result;
+	result.bind(sf::Keyboard::W, PlayerAction::Forward);
+	result.bind(sf::Keyboard::Up, PlayerAction::Forward);
+	result.bind(sf::Keyboard::S, PlayerAction::Backward);
+	result.bind(sf::Keyboard::Down, PlayerAction::Backward);
+	result.bind(sf::Keyboard::A, PlayerAction::Left);
+	result.bind(sf::Keyboard::Left, PlayerAction::Left);
+	result.bind(sf::Keyboard::D, PlayerAction::Right);
+	result.bind(sf::Keyboard::Right, PlayerAction::Right);
+	result.bind(sf::Keyboard::Space, PlayerAction::Fire);
+	return result;
+}
+
+/// Binds the given key to the given action.
+void KeyBindings::bind(sf::Keyboard::Key key, PlayerAction action)
+{
+	this->actions[key] = static_cast<std::uint8_t>(static_cast<int>(action) + 1);
+}
+
+/// Tries to find the action that the given key is bound to.
+bool KeyBindings::tryGetAction(sf::Keyboard::Key key, PlayerAction& result) const
+{
+	if (key < 0 || key >= sf::Keyboard::KeyCount || this->actions[key] == 0)
+		return false;
+
+	result = static_cast<PlayerAction>(this->actions[key] - 1);
+	return true;
+}
+
+/// Tries to parse the given key name.
+bool KeyBindings::tryParseKey(const std::string& name, sf::Keyboard::Key& result)
+{
+	for (int i = 0; i < sf::Keyboard::KeyCount; i++)
+	{
+		if (name == KeyNames[i])
+		{
+			result = static_cast<sf::Keyboard::Key>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+/// Tries to parse the given action name.
+bool KeyBindings::tryParseAction(const std::string& name, PlayerAction& result)
+{
+	for (std::size_t i = 0; i < sizeof(ActionNames) / sizeof(ActionNames[0]); i++)
+	{
+		if (name == ActionNames[i])
+		{
+			result = static_cast<PlayerAction>(i);
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <SFML/Window/Keyboard.hpp>
+#include "InputState.h"
+
+namespace si
+{
+	/// Defines a set of key bindings, which map keys to the
+	/// player actions that they trigger. Every key is bound to
+	/// at most one action, but an action can have any number
+	/// of keys.
+	class KeyBindings final
+	{
+	public:
+		/// Creates a set of key bindings in which no keys are bound.
+		KeyBindings();
+
+		/// Gets the default key bindings: W, A, S, D and the
+		/// arrow keys move the player, and space fires.
+		static KeyBindings getDefault();
+
+		/// Binds the given key to the given action. The key's
+		/// previous binding, if any, is replaced.
+		void bind(sf::Keyboard::Key key, PlayerAction action);
+
+		/// Tries to find the action that the given key is bound
+		/// to. A boolean is returned that tells if the key is bound.
+		bool tryGetAction(sf::Keyboard::Key key, PlayerAction& result) const;
+
+		/// Tries to parse the given key name, which is the name
+		/// of a member of the sf::Keyboard::Key enumeration, such
+		/// as "W", "Up" or "Space". A boolean is returned that
+		/// tells if the name was recognized.
+		static bool tryParseKey(const std::string& name, sf::Keyboard::Key& result);
+
+		/// Tries to parse the given action name, which is one of
+		/// "forward", "backward", "left", "right" or "fire". A
+		/// boolean is returned that tells if the name was recognized.
+		static bool tryParseAction(const std::string& name, PlayerAction& result);
+
+	private:
+		/// Maps every key to its action's index plus one, or
+		/// to zero if the key is not bound.
+		std::array<std::uint8_t, sf::Keyboard::KeyCount> actions;
+	};
+}
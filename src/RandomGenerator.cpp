@@ -1,7 +1,150 @@
 #include "RandomGenerator.h"
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <random>
 
 using namespace si;
 
-RandomGenerator RandomGenerator::instance{};
\ No newline at end of file
+namespace
+{
+	/// Rotates the given integer left by the given number of bits.
+	inline std::uint64_t rotateLeft(std::uint64_t value, int count)
+	{
+		return (value << count) | (value >> (64 - count));
+	}
+
+	/// Advances the given splitmix64 state, and returns the next
+	/// integer in its sequence. This is used to expand seeds
+	/// into generator states.
+	std::uint64_t splitMix(std::uint64_t& state)
+	{
+		std::uint64_t result = (state += 0x9E3779B97F4A7C15ULL);
+		result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		result = (result ^ (result >> 27)) * 0x94D049BB133111EBULL;
+		return result ^ (result >> 31);
+	}
+
+	const double TwoPi = 6.283185307179586476925286766559;
+}
+
+RandomGenerator::RandomGenerator()
+	: seedValue(0), state(), buffer(), bufferPosition(LaneCount)
+{
+	this->seed(std::random_device()());
+}
+
+RandomGenerator RandomGenerator::instance{};
+thread_local RandomGenerator RandomGenerator::effects{};
+
+/// Fills the given array with random floating-point
+/// numbers that are uniformly distributed within the
+/// given range.
+void RandomGenerator::fillReal(double* values, std::size_t count, double min, double max)
+{
+	double range = max - min;
+	std::size_t i = 0;
+	for (; i + LaneCount <= count; i += LaneCount)
+	{
+		std::uint64_t bits[LaneCount];
+		this->nextBlock(bits);
+		for (std::size_t lane = 0; lane < LaneCount; lane++)
+		{
+			values[i + lane] = min + range * toUnit(bits[lane]);
+		}
+	}
+	for (; i < count; i++)
+	{
+		values[i] = min + range * this->nextUnit();
+	}
+}
+
+/// Fills the given array with random floating-point
+/// numbers that are normally distributed with the given
+/// mean and standard deviation.
+void RandomGenerator::fillNormal(double* values, std::size_t count, double mean, double standardDeviation)
+{
+	// Use the Box-Muller transform, which turns pairs of
+	// uniformly distributed numbers into pairs of normally
+	// distributed numbers. Generate the uniform numbers in
+	// bulk first.
+	this->fillReal(values, count, 0.0, 1.0);
+	for (std::size_t i = 0; i < count; i += 2)
+	{
+		// Avoid taking the logarithm of zero.
+		double radius = standardDeviation * std::sqrt(-2.0 * std::log(1.0 - values[i]));
+		double angle = TwoPi * (i + 1 < count ? values[i + 1] : this->nextUnit());
+		values[i] = mean + radius * std::cos(angle);
+		if (i + 1 < count)
+			values[i + 1] = mean + radius * std::sin(angle);
+	}
+}
+
+/// Generates a random 64-bit integer.
+RandomGenerator::result_type RandomGenerator::operator()()
+{
+	if (this->bufferPosition == LaneCount)
+	{
+		this->nextBlock(this->buffer);
+		this->bufferPosition = 0;
+	}
+	return this->buffer[this->bufferPosition++];
+}
+
+/// Restarts this random number generator's sequence
+/// from the given seed.
+void RandomGenerator::seed(std::uint32_t value)
+{
+	this->seedValue = value;
+
+	// Every lane gets its own, independent state.
+	std::uint64_t seedState = value;
+	for (std::size_t lane = 0; lane < LaneCount; lane++)
+	{
+		for (int word = 0; word < 4; word++)
+		{
+			this->state[word][lane] = splitMix(seedState);
+		}
+	}
+	this->bufferPosition = LaneCount;
+}
+
+/// Gets the seed that this random number generator's
+/// sequence was last started from.
+std::uint32_t RandomGenerator::getSeed() const
+{
+	return this->seedValue;
+}
+
+/// Generates one random integer per lane.
+void RandomGenerator::nextBlock(std::uint64_t* results)
+{
+	auto& s = this->state;
+	for (std::size_t lane = 0; lane < LaneCount; lane++)
+	{
+		results[lane] = rotateLeft(s[1][lane] * 5, 7) * 9;
+		std::uint64_t t = s[1][lane] << 17;
+		s[2][lane] ^= s[0][lane];
+		s[3][lane] ^= s[1][lane];
+		s[1][lane] ^= s[2][lane];
+		s[0][lane] ^= s[3][lane];
+		s[2][lane] ^= t;
+		s[3][lane] = rotateLeft(s[3][lane], 45);
+	}
+}
+
+/// Generates a random floating-point number in the
+/// range [0, 1).
+double RandomGenerator::nextUnit()
+{
+	return toUnit((*this)());
+}
+
+/// Converts the given random integer to a floating-point
+/// number in the range [0, 1).
+double RandomGenerator::toUnit(std::uint64_t bits)
+{
+	// Use the top 53 bits, which fill a double's mantissa.
+	return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
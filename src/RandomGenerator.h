@@ -1,13 +1,31 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
 
 namespace si
 {
 	/// A singleton class that generates random numbers.
+	///
+	/// There are two instances: one for the simulation, and
+	/// one for visual effects. The simulation's random numbers
+	/// must only depend on its seed, so that games can be
+	/// replayed. Visual effects are not drawn when a game is
+	/// replayed without rendering, so they get their own stream.
+	/// Every thread has its own stream for visual effects, so
+	/// threads never contend on a shared generator.
+	///
+	/// Random numbers are generated by a xoshiro256** generator
+	/// that runs several independent lanes side by side. The
+	/// lanes are updated in lockstep, which the compiler can
+	/// vectorize, and which makes filling arrays with random
+	/// numbers much cheaper than drawing them one at a time.
 	class RandomGenerator final
 	{
 	public:
+		typedef std::uint64_t result_type;
+
 		/// Disallow copying the random number generator: this is a
 		/// singleton class which will never go out of scope,
 		/// so it can just be passed around by reference.
@@ -18,8 +36,7 @@ namespace si
 		template<typename T>
 		T nextReal(T min, T max)
 		{
-			std::uniform_real_distribution<T> dist(min, max);
-			return dist(twister);
+			return min + static_cast<T>((max - min) * this->nextUnit());
 		}
 
 		/// Conjures up a random integer number that is of the given type
@@ -28,16 +45,79 @@ namespace si
 		T nextInt(T min, T max)
 		{
 			std::uniform_int_distribution<T> dist(min, max);
-			return dist(twister);
+			return dist(*this);
+		}
+
+		/// Fills the given array with random floating-point
+		/// numbers that are uniformly distributed within the
+		/// given range.
+		void fillReal(double* values, std::size_t count, double min, double max);
+
+		/// Fills the given array with random floating-point
+		/// numbers that are normally distributed with the given
+		/// mean and standard deviation.
+		void fillNormal(double* values, std::size_t count, double mean, double standardDeviation);
+
+		/// Generates a random 64-bit integer. This allows the random
+		/// number generator to be used with the standard library's
+		/// distributions.
+		result_type operator()();
+
+		/// Gets the smallest integer that this random number
+		/// generator can generate.
+		static constexpr result_type min()
+		{
+			return 0;
+		}
+
+		/// Gets the largest integer that this random number
+		/// generator can generate.
+		static constexpr result_type max()
+		{
+			return UINT64_MAX;
 		}
 
-		/// This random number generator's one and only instance.
+		/// Restarts this random number generator's sequence
+		/// from the given seed.
+		void seed(std::uint32_t value);
+
+		/// Gets the seed that this random number generator's
+		/// sequence was last started from.
+		std::uint32_t getSeed() const;
+
+		/// The random number generator for the simulation.
 		static RandomGenerator instance;
 
+		/// The current thread's random number generator for
+		/// visual effects, which do not affect the simulation.
+		static thread_local RandomGenerator effects;
+
 	private:
-		RandomGenerator()
-		{ }
+		/// The number of lanes that are updated in lockstep.
+		static const std::size_t LaneCount = 4;
+
+		RandomGenerator();
+
+		/// Generates one random integer per lane.
+		void nextBlock(std::uint64_t* results);
+
+		/// Generates a random floating-point number in the
+		/// range [0, 1).
+		double nextUnit();
+
+		/// Converts the given random integer to a floating-point
+		/// number in the range [0, 1).
+		static double toUnit(std::uint64_t bits);
+
+		std::uint32_t seedValue;
+
+		/// The generator's state, which is stored lane by lane
+		/// for every state word.
+		std::uint64_t state[4][LaneCount];
 
-		std::mt19937 twister = std::mt19937(std::random_device()());
+		/// Integers that have been generated, but which have
+		/// not been used yet.
+		std::uint64_t buffer[LaneCount];
+		std::size_t bufferPosition;
 	};
 }
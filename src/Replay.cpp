@@ -0,0 +1,265 @@
+#include "Replay.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Common.h"
+#include "InputState.h"
+#include "model/Entity.h"
+#include "model/Game.h"
+#include "model/PhysicsEntity.h"
+
+using namespace si;
+
+namespace
+{
+	const char ReplayMagic[4] = { 'S', 'I', 'R', 'P' };
+	const std::uint32_t ReplayVersion = 1;
+
+	/// The number of bytes that a run of frames
+	/// takes up in a replay file.
+	const std::size_t RunByteSize = 4 + 8 + 1;
+
+	/// Appends the given integer to the given buffer, as
+	/// a little-endian integer of the given size.
+	void writeUInt(std::vector<char>& target, std::uint64_t value, int byteCount)
+	{
+		for (int i = 0; i < byteCount; i++)
+		{
+			target.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+		}
+	}
+
+	/// Reads a little-endian integer of the given size
+	/// from the given buffer.
+	std::uint64_t readUInt(
+		const std::vector<char>& data, std::size_t& offset,
+		int byteCount, const std::string& path)
+	{
+		if (data.size() - offset < static_cast<std::size_t>(byteCount))
+		{
+			throw ReplayException("'" + path + "' is not a valid replay, because it ends unexpectedly.");
+		}
+
+		std::uint64_t result = 0;
+		for (int i = 0; i < byteCount; i++)
+		{
+			result |= static_cast<std::uint64_t>(
+				static_cast<unsigned char>(data[offset + i])) << (8 * i);
+		}
+		offset += byteCount;
+		return result;
+	}
+
+	/// Gets the bits of the given floating-point number.
+	std::uint64_t getBits(double value)
+	{
+		std::uint64_t result;
+		std::memcpy(&result, &value, sizeof(result));
+		return result;
+	}
+
+	/// Creates a floating-point number from the given bits.
+	double fromBits(std::uint64_t bits)
+	{
+		double result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	/// Mixes the given value into the given FNV-1a hash.
+	void hashValue(std::uint64_t& hash, std::uint64_t value)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			hash ^= (value >> (8 * i)) & 0xFF;
+			hash *= 1099511628211ULL;
+		}
+	}
+}
+
+// This is over three days of frames at 60 frames per
+// second, or almost a day at 240 frames per second.
+const std::uint64_t Replay::MaxFrameCount = 16 * 1024 * 1024;
+
+ReplayException::ReplayException(const std::string& message)
+	: std::runtime_error(message)
+{ }
+
+/// Creates an empty replay for a game whose random
+/// generator was started from the given seed.
+Replay::Replay(std::uint32_t seed)
+	: seed(seed), checksum(0), frames()
+{ }
+
+/// Gets the seed that the game's random generator
+/// was started from.
+std::uint32_t Replay::getSeed() const
+{
+	return this->seed;
+}
+
+/// Appends a frame to this replay.
+void Replay::addFrame(duration_t timeDelta, InputState input)
+{
+	this->frames.push_back(ReplayFrame { timeDelta, input });
+}
+
+/// Gets all frames in this replay.
+const std::vector<ReplayFrame>& Replay::getFrames() const
+{
+	return this->frames;
+}
+
+/// Gets the total amount of time that this replay's
+/// frames simulate.
+duration_t Replay::getDuration() const
+{
+	duration_t result(0.0);
+	for (const auto& item : this->frames)
+	{
+		result += item.timeDelta;
+	}
+	return result;
+}
+
+/// Gets the checksum of the game's state after the
+/// last frame.
+std::uint64_t Replay::getChecksum() const
+{
+	return this->checksum;
+}
+
+/// Sets the checksum of the game's state after the
+/// last frame.
+void Replay::setChecksum(std::uint64_t checksum)
+{
+	this->checksum = checksum;
+}
+
+/// Writes this replay to the file at the given path.
+void Replay::save(const std::string& path) const
+{
+	std::vector<char> runs;
+	std::uint32_t runCount = 0;
+	for (std::size_t i = 0; i < this->frames.size(); )
+	{
+		// Find the end of the run of frames that are
+		// identical to this one.
+		const auto& frame = this->frames[i];
+		auto deltaBits = getBits(frame.timeDelta.count());
+		std::size_t end = i + 1;
+		while (end < this->frames.size()
+			&& end - i < UINT32_MAX
+			&& getBits(this->frames[end].timeDelta.count()) == deltaBits
+			&& this->frames[end].input == frame.input)
+		{
+			end++;
+		}
+
+		writeUInt(runs, end - i, 4);
+		writeUInt(runs, deltaBits, 8);
+		writeUInt(runs, frame.input.getBits(), 1);
+		runCount++;
+		i = end;
+	}
+
+	std::vector<char> data(std::begin(ReplayMagic), std::end(ReplayMagic));
+	writeUInt(data, ReplayVersion, 4);
+	writeUInt(data, this->seed, 4);
+	writeUInt(data, this->checksum, 8);
+	writeUInt(data, runCount, 4);
+	data.insert(data.end(), runs.begin(), runs.end());
+
+	std::ofstream stream(path, std::ios::binary);
+	stream.write(data.data(), data.size());
+	if (!stream)
+	{
+		throw ReplayException("Couldn't write replay file '" + path + "'.");
+	}
+}
+
+/// Reads the replay file at the given path.
+Replay Replay::load(const std::string& path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+	{
+		throw ReplayException("Couldn't open replay file '" + path + "'.");
+	}
+	std::vector<char> data(
+		(std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	if (data.size() < sizeof(ReplayMagic)
+		|| std::memcmp(data.data(), ReplayMagic, sizeof(ReplayMagic)) != 0)
+	{
+		throw ReplayException("'" + path + "' is not a replay file.");
+	}
+
+	std::size_t offset = sizeof(ReplayMagic);
+	if (readUInt(data, offset, 4, path) != ReplayVersion)
+	{
+		throw ReplayException("'" + path + "' was recorded by a different version.");
+	}
+
+	Replay result(static_cast<std::uint32_t>(readUInt(data, offset, 4, path)));
+	result.checksum = readUInt(data, offset, 8, path);
+	auto runCount = readUInt(data, offset, 4, path);
+	if ((data.size() - offset) / RunByteSize < runCount)
+	{
+		throw ReplayException("'" + path + "' is not a valid replay, because it ends unexpectedly.");
+	}
+
+	std::uint64_t totalFrameCount = 0;
+	for (std::uint64_t i = 0; i < runCount; i++)
+	{
+		auto frameCount = readUInt(data, offset, 4, path);
+		duration_t timeDelta(fromBits(readUInt(data, offset, 8, path)));
+		InputState input(static_cast<std::uint8_t>(readUInt(data, offset, 1, path)));
+
+		// Check the frame count before allocating any frames,
+		// so corrupt files can't exhaust memory.
+		totalFrameCount += frameCount;
+		if (totalFrameCount > MaxFrameCount)
+		{
+			throw ReplayException(
+				"'" + path + "' is not a valid replay, because it has more than "
+				+ std::to_string(MaxFrameCount) + " frames.");
+		}
+		result.frames.insert(result.frames.end(), frameCount, ReplayFrame { timeDelta, input });
+	}
+
+	if (offset != data.size())
+	{
+		throw ReplayException("'" + path + "' is not a valid replay, because it has trailing data.");
+	}
+	return result;
+}
+
+/// Computes a checksum of the given game's state.
+std::uint64_t si::computeChecksum(const si::model::Game& game)
+{
+	std::uint64_t hash = 14695981039346656037ULL;
+	hashValue(hash, getBits(game.getLifetime().count()));
+	for (const auto& item : game.getAll<si::model::Entity>())
+	{
+		auto pos = item->getPosition();
+		hashValue(hash, getBits(pos.x));
+		hashValue(hash, getBits(pos.y));
+		hashValue(hash, getBits(item->getLifetime().count()));
+
+		auto physItem = std::dynamic_pointer_cast<si::model::PhysicsEntity>(item);
+		if (physItem != nullptr)
+		{
+			auto vel = physItem->getVelocity();
+			hashValue(hash, getBits(vel.x));
+			hashValue(hash, getBits(vel.y));
+		}
+	}
+	return hash;
+}
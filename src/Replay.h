@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Common.h"
+#include "InputState.h"
+#include "model/Game.h"
+
+namespace si
+{
+	/// An exception class for replays that cannot be
+	/// read or written.
+	class ReplayException : public std::runtime_error
+	{
+	public:
+		ReplayException(const std::string& message);
+	};
+
+	/// Describes a single frame of a recorded game.
+	struct ReplayFrame
+	{
+		/// The amount of time that the frame simulated.
+		duration_t timeDelta;
+		/// The player's input during the frame.
+		InputState input;
+	};
+
+	/// Defines a recording of a game. A game's simulation only
+	/// depends on the random generator's seed, and on every
+	/// frame's time delta and input, so that is all that a replay
+	/// stores. A checksum of the game's final state is stored as
+	/// well, which tells if a replay was played back exactly.
+	///
+	/// Replay files store runs of identical frames only once,
+	/// which makes games that are recorded with a fixed time
+	/// delta very compact. All integers are unsigned and
+	/// little-endian. The file layout is:
+	///
+	///     "SIRP"  version (32-bit)
+	///     seed (32-bit)  checksum (64-bit)
+	///     runCount (32-bit)
+	///     runs[runCount]
+	///
+	/// where every run is:
+	///
+	///     frameCount (32-bit)  timeDelta (64-bit, IEEE 754 bits)
+	///     input (8-bit)
+	class Replay final
+	{
+	public:
+		/// Creates an empty replay for a game whose random
+		/// generator was started from the given seed.
+		Replay(std::uint32_t seed);
+
+		/// Gets the seed that the game's random generator
+		/// was started from.
+		std::uint32_t getSeed() const;
+
+		/// Appends a frame to this replay.
+		void addFrame(duration_t timeDelta, InputState input);
+
+		/// Gets all frames in this replay.
+		const std::vector<ReplayFrame>& getFrames() const;
+
+		/// Gets the total amount of time that this replay's
+		/// frames simulate.
+		duration_t getDuration() const;
+
+		/// Gets the checksum of the game's state after the
+		/// last frame.
+		std::uint64_t getChecksum() const;
+
+		/// Sets the checksum of the game's state after the
+		/// last frame.
+		void setChecksum(std::uint64_t checksum);
+
+		/// Writes this replay to the file at the given path.
+		/// A ReplayException is thrown if this fails.
+		void save(const std::string& path) const;
+
+		/// Reads the replay file at the given path. A
+		/// ReplayException is thrown if the file cannot be
+		/// read, if it is malformed, or if it has more than
+		/// MaxFrameCount frames.
+		static Replay load(const std::string& path);
+
+		/// The maximal number of frames that a replay file may
+		/// have. This protects against corrupt files that claim
+		/// to have more frames than could ever be stored.
+		static const std::uint64_t MaxFrameCount;
+
+	private:
+		std::uint32_t seed;
+		std::uint64_t checksum;
+		std::vector<ReplayFrame> frames;
+	};
+
+	/// Computes a checksum of the given game's state, which
+	/// consists of the positions and lifetimes of all entities
+	/// in the game. Games that have been simulated identically
+	/// have identical checksums.
+	std::uint64_t computeChecksum(const si::model::Game& game);
+}
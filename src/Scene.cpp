@@ -2,44 +2,44 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <exception>
 #include <functional>
-#include <map>
 #include <set>
+#include <vector>
 #include <SFML/Graphics.hpp>
+#include "FlagSet.h"
+#include "InputState.h"
+#include "KeyBindings.h"
+#include "model/CollisionLayers.h"
 #include "model/Entity.h"
 #include "model/ShipEntity.h"
 #include "model/Game.h"
 #include "controller/IController.h"
 #include "controller/GameController.h"
-#include "controller/OutOfBoundsController.h"
 #include "view/IRenderable.h"
 #include "view/RenderContext.h"
 #include "view/GameRenderer.h"
 #include "view/PathOffsetRenderable.h"
 #include "view/TransformedRenderable.h"
 #include "timeline/Timeline.h"
+#include "timeline/VoicePool.h"
 
 using namespace si;
 
 Scene::Scene(
 	const std::string& name, sf::Vector2u dimensions,
 	sf::Color backgroundColor)
-	: name(name), dimensions(dimensions), game(), renderer(backgroundColor),
-	  controller(), sceneEvents(), associatedView(), flags()
+	: name(name), dimensions(dimensions), frameRate(0), quality(), game(), renderer(backgroundColor),
+	  controller(), sceneEvents(), voicePool(), entitySlots(), freeEntitySlots(), flags(), collisionLayers(),
+	  input(), keyBindings(KeyBindings::getDefault())
 {
 	// Create an event handler that removes the
-	// associated view when the model is removed.
+	// associated view and controllers when the
+	// model is removed.
 	game.registerRemoveHandler([&](const si::model::Entity_ptr& item)
 	{
-		auto assocView = this->associatedView[item];
-		if (assocView != nullptr)
-		{
-			// Remove the associated view from the map.
-			renderer.remove(assocView);
-			// Remove the model from the map.
-			this->associatedView.erase(item);
-		}
+		this->releaseSlot(*item);
 	});
 }
 
@@ -48,11 +48,25 @@ Scene::Scene(
 /// tells us how much time has
 /// passed since the previous frame.
 void Scene::frame(sf::RenderTarget& renderTarget, duration_t timeDelta)
+{
+	this->update(timeDelta);
+	this->render(renderTarget, timeDelta);
+}
+
+/// Advances the simulation by the given duration,
+/// without rendering anything.
+void Scene::update(duration_t timeDelta)
 {
 	this->game.updateTime(timeDelta);
 	this->controller.update(this->game, timeDelta);
 	this->updateEvents(timeDelta);
-	auto context = si::view::RenderContext(renderTarget, timeDelta);
+}
+
+/// Renders the scene's current state to the given
+/// render target.
+void Scene::render(sf::RenderTarget& renderTarget, duration_t timeDelta)
+{
+	auto context = si::view::RenderContext(renderTarget, timeDelta, this->quality);
 	this->renderer.render(context, context.getBounds(), si::view::Transformation());
 }
 
@@ -63,8 +77,16 @@ void Scene::addEntity(
 	const si::view::IRenderable_ptr& view)
 {
 	this->game.add(model);
-	this->renderer.add(view);
-	this->associatedView[model] = view;
+
+	auto& slot = this->entitySlots[this->acquireSlot(*model)];
+	if (slot.hasView)
+	{
+		// The entity was already associated with a view.
+		// Replace that view.
+		this->renderer.remove(slot.view);
+	}
+	slot.view = this->renderer.add(view);
+	slot.hasView = true;
 }
 
 /// Adds a renderable (view) element to
@@ -72,10 +94,10 @@ void Scene::addEntity(
 /// with anything in the model. This
 /// can be useful when constructing a
 /// background, or an HUD.
-void Scene::addRenderable(
+si::view::RenderHandle Scene::addRenderable(
 	const si::view::IRenderable_ptr& view)
 {
-	this->renderer.add(view);
+	return this->renderer.add(view);
 }
 
 /// Constrains the given entity to the
@@ -86,7 +108,7 @@ void Scene::addBoundsConstraint(
 	const si::model::Entity_ptr& model,
 	si::DoubleRect bounds)
 {
-	this->addController(std::make_shared<si::controller::OutOfBoundsController>(model, bounds));
+	this->game.addBoundsConstraint(model, bounds);
 }
 
 /// Adds the given controller to this scene.
@@ -96,6 +118,16 @@ void Scene::addController(
 	this->controller.add(item);
 }
 
+/// Adds the given controller to this scene, and
+/// attaches it to the given entity.
+void Scene::addController(
+	const si::controller::IController_ptr& item,
+	const si::model::Entity_ptr& owner)
+{
+	this->controller.add(item);
+	this->entitySlots[this->acquireSlot(*owner)].controllers.push_back(item);
+}
+
 /// Starts the given timeline event for this
 /// scene. The timeline event will be updated
 /// on every frame, until it has ended, at
@@ -112,13 +144,14 @@ void Scene::startEvent(
 /// Gets the boolean flag with the given name.
 bool Scene::getFlag(const std::string& name) const
 {
-	if (this->flags.find(name) == this->flags.end())
+	FlagId id;
+	if (this->flags.tryGetId(name, id))
 	{
-		return false;
+		return this->flags.get(id);
 	}
 	else
 	{
-		return this->flags.at(name);
+		return false;
 	}
 }
 
@@ -126,7 +159,72 @@ bool Scene::getFlag(const std::string& name) const
 /// given value.
 void Scene::setFlag(const std::string& name, bool value)
 {
-	this->flags[name] = value;
+	this->flags.set(this->flags.intern(name), value);
+}
+
+/// Gets the boolean flag with the given identifier.
+bool Scene::getFlag(FlagId id) const
+{
+	return this->flags.get(id);
+}
+
+/// Sets the boolean flag with the given identifier
+/// to the given value.
+void Scene::setFlag(FlagId id, bool value)
+{
+	this->flags.set(id, value);
+}
+
+/// Gets the player's input for the current frame.
+const InputState& Scene::getInput() const
+{
+	return this->input;
+}
+
+/// Sets the player's input for the current frame.
+void Scene::setInput(InputState input)
+{
+	this->input = input;
+}
+
+/// Gets the key bindings that map the player's keys
+/// to player actions.
+const KeyBindings& Scene::getKeyBindings() const
+{
+	return this->keyBindings;
+}
+
+/// Sets the key bindings that map the player's keys
+/// to player actions.
+void Scene::setKeyBindings(const KeyBindings& bindings)
+{
+	this->keyBindings = bindings;
+}
+
+/// Gets this scene's flag set.
+FlagSet& Scene::getFlags()
+{
+	return this->flags;
+}
+
+/// Gets this scene's flag set.
+const FlagSet& Scene::getFlags() const
+{
+	return this->flags;
+}
+
+/// Gets the set of collision layers that this
+/// scene's entities are in.
+si::model::CollisionLayerSet& Scene::getCollisionLayers()
+{
+	return this->collisionLayers;
+}
+
+/// Gets the set of collision layers that this
+/// scene's entities are in.
+const si::model::CollisionLayerSet& Scene::getCollisionLayers() const
+{
+	return this->collisionLayers;
 }
 
 /// Gets this scene's name.
@@ -141,6 +239,34 @@ sf::Vector2u Scene::getDimensions() const
 	return this->dimensions;
 }
 
+/// Gets the number of frames per second at which this
+/// scene recommends to be displayed.
+unsigned int Scene::getFrameRate() const
+{
+	return this->frameRate;
+}
+
+/// Sets the number of frames per second at which this
+/// scene recommends to be displayed.
+void Scene::setFrameRate(unsigned int frameRate)
+{
+	this->frameRate = frameRate;
+}
+
+/// Gets the quality settings that this scene's
+/// visual effects are rendered with.
+si::view::QualitySettings Scene::getQuality() const
+{
+	return this->quality;
+}
+
+/// Sets the quality settings that this scene's
+/// visual effects are rendered with.
+void Scene::setQuality(const si::view::QualitySettings& quality)
+{
+	this->quality = quality;
+}
+
 /// Gets this scene's game.
 si::model::Game& Scene::getGame()
 {
@@ -177,6 +303,74 @@ const si::controller::GameController& Scene::getController() const
 	return this->controller;
 }
 
+/// Gets the voice pool that plays this scene's sounds.
+si::timeline::VoicePool& Scene::getVoicePool()
+{
+	return this->voicePool;
+}
+
+/// Gets the voice pool that plays this scene's sounds.
+const si::timeline::VoicePool& Scene::getVoicePool() const
+{
+	return this->voicePool;
+}
+
+/// Gets the given entity's slot index, assigning
+/// it a slot if it does not have one yet.
+std::size_t Scene::acquireSlot(si::model::Entity& model)
+{
+	auto index = model.getSlot();
+	if (index != si::model::Entity::NoSlot)
+		return index;
+
+	if (this->freeEntitySlots.empty())
+	{
+		index = this->entitySlots.size();
+		this->entitySlots.push_back(EntitySlot());
+	}
+	else
+	{
+		index = this->freeEntitySlots.back();
+		this->freeEntitySlots.pop_back();
+	}
+
+	this->entitySlots[index].hasView = false;
+	model.setSlot(index);
+	return index;
+}
+
+/// Releases the given entity's slot, and removes
+/// its associated view and controllers from the
+/// scene.
+void Scene::releaseSlot(si::model::Entity& model)
+{
+	auto index = model.getSlot();
+	if (index == si::model::Entity::NoSlot)
+		return;
+
+	auto& slot = this->entitySlots[index];
+	if (slot.hasView)
+	{
+		this->renderer.remove(slot.view);
+		slot.hasView = false;
+	}
+
+	// Controllers that are attached to the entity have
+	// nothing left to control. Release them now, rather
+	// than waiting for them to notice that themselves. They
+	// are removed in the controller's next sweep, so
+	// destroying many entities at once doesn't scan the
+	// controller list once per entity.
+	for (const auto& item : slot.controllers)
+	{
+		this->controller.release(item);
+	}
+	slot.controllers.clear();
+
+	model.setSlot(si::model::Entity::NoSlot);
+	this->freeEntitySlots.push_back(index);
+}
+
 void Scene::updateEvents(duration_t timeDelta)
 {
 	// Create a copy of the events vector, because updating events could result
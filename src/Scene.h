@@ -1,11 +1,16 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <exception>
 #include <functional>
-#include <map>
 #include <string>
+#include <vector>
 #include <SFML/Graphics.hpp>
+#include "FlagSet.h"
+#include "InputState.h"
+#include "KeyBindings.h"
+#include "model/CollisionLayers.h"
 #include "model/Entity.h"
 #include "model/ShipEntity.h"
 #include "model/Game.h"
@@ -15,6 +20,7 @@
 #include "view/RenderContext.h"
 #include "view/GameRenderer.h"
 #include "timeline/Timeline.h"
+#include "timeline/VoicePool.h"
 
 namespace si
 {
@@ -40,6 +46,17 @@ namespace si
 		/// passed since the previous frame.
 		void frame(sf::RenderTarget& renderTarget, duration_t timeDelta);
 
+		/// Advances the simulation by the given duration,
+		/// without rendering anything. The simulation only
+		/// depends on the time deltas and input states that
+		/// it is given, and on the random generator's seed.
+		void update(duration_t timeDelta);
+
+		/// Renders the scene's current state to the given
+		/// render target. A duration tells us how much time
+		/// has passed since the previous frame.
+		void render(sf::RenderTarget& renderTarget, duration_t timeDelta);
+
 		/// Adds an entity that is associated with
 		/// a view to this scene.
 		void addEntity(
@@ -50,8 +67,11 @@ namespace si
 		/// this scene that is not associated
 		/// with anything in the model. This
 		/// can be useful to construct a
-		/// background, or an HUD.
-		void addRenderable(
+		/// background, or an HUD. A handle
+		/// is returned that can be used to
+		/// remove the renderable from the
+		/// scene's renderer.
+		si::view::RenderHandle addRenderable(
 			const si::view::IRenderable_ptr& view);
 
 		/// Constrains the given entity to the
@@ -66,6 +86,14 @@ namespace si
 		void addController(
 			const si::controller::IController_ptr& item);
 
+		/// Adds the given controller to this scene, and
+		/// attaches it to the given entity. The controller
+		/// is removed from the scene as soon as the entity
+		/// is removed from the game.
+		void addController(
+			const si::controller::IController_ptr& item,
+			const si::model::Entity_ptr& owner);
+
 		/// Starts the given timeline event for this
 		/// scene. The timeline event will be updated
 		/// on every frame, until it has ended, at
@@ -80,12 +108,65 @@ namespace si
 		/// given value.
 		void setFlag(const std::string& name, bool value);
 
+		/// Gets the boolean flag with the given identifier.
+		bool getFlag(FlagId id) const;
+
+		/// Sets the boolean flag with the given identifier
+		/// to the given value.
+		void setFlag(FlagId id, bool value);
+
+		/// Gets the player's input for the current frame.
+		const InputState& getInput() const;
+
+		/// Sets the player's input for the current frame.
+		void setInput(InputState input);
+
+		/// Gets the key bindings that map the player's keys
+		/// to player actions.
+		const KeyBindings& getKeyBindings() const;
+
+		/// Sets the key bindings that map the player's keys
+		/// to player actions.
+		void setKeyBindings(const KeyBindings& bindings);
+
+		/// Gets this scene's flag set.
+		FlagSet& getFlags();
+
+		/// Gets this scene's flag set.
+		const FlagSet& getFlags() const;
+
+		/// Gets the set of collision layers that this
+		/// scene's entities are in.
+		si::model::CollisionLayerSet& getCollisionLayers();
+
+		/// Gets the set of collision layers that this
+		/// scene's entities are in.
+		const si::model::CollisionLayerSet& getCollisionLayers() const;
+
 		/// Gets this scene's name.
 		std::string getName() const;
 
 		/// Gets recommended dimensions for this scene's render target.
 		sf::Vector2u getDimensions() const;
 
+		/// Gets the number of frames per second at which this
+		/// scene recommends to be displayed, or zero if it has
+		/// no such recommendation.
+		unsigned int getFrameRate() const;
+
+		/// Sets the number of frames per second at which this
+		/// scene recommends to be displayed. Zero means that it
+		/// has no such recommendation.
+		void setFrameRate(unsigned int frameRate);
+
+		/// Gets the quality settings that this scene's
+		/// visual effects are rendered with.
+		si::view::QualitySettings getQuality() const;
+
+		/// Sets the quality settings that this scene's
+		/// visual effects are rendered with.
+		void setQuality(const si::view::QualitySettings& quality);
+
 		/// Gets this scene's game.
 		si::model::Game& getGame();
 
@@ -104,6 +185,12 @@ namespace si
 		/// Gets this scene's controller.
 		const si::controller::GameController& getController() const;
 
+		/// Gets the voice pool that plays this scene's sounds.
+		si::timeline::VoicePool& getVoicePool();
+
+		/// Gets the voice pool that plays this scene's sounds.
+		const si::timeline::VoicePool& getVoicePool() const;
+
 		/// Creates a renderable from the given view that
 		/// traces the given entity's position and
 		/// orientation.
@@ -112,18 +199,51 @@ namespace si
 			const si::view::IRenderable_ptr& view);
 
 	private:
+		/// Describes the scene's bookkeeping for an entity
+		/// that has been assigned a slot.
+		struct EntitySlot
+		{
+			/// A handle to the entity's associated view,
+			/// if it has one.
+			si::view::RenderHandle view;
+			bool hasView;
+
+			/// The controllers that are attached to
+			/// the entity.
+			std::vector<si::controller::IController_ptr> controllers;
+		};
+
+		/// Gets the given entity's slot index, assigning
+		/// it a slot if it does not have one yet.
+		std::size_t acquireSlot(si::model::Entity& model);
+
+		/// Releases the given entity's slot, and removes
+		/// its associated view and controllers from the
+		/// scene.
+		void releaseSlot(si::model::Entity& model);
+
 		/// Updates all events that are currently running,
 		/// and removes any events that have ended.
 		void updateEvents(duration_t timeDelta);
 
 		std::string name;
 		sf::Vector2u dimensions;
+		unsigned int frameRate;
+		si::view::QualitySettings quality;
 
 		si::model::Game game;
 		si::view::GameRenderer renderer;
 		si::controller::GameController controller;
 		std::vector<si::timeline::ITimelineEvent_ptr> sceneEvents;
-		std::map<si::model::Entity_ptr, si::view::IRenderable_ptr> associatedView;
-		std::map<std::string, bool> flags;
+		si::timeline::VoicePool voicePool;
+
+		/// Maps entity slot indices to the scene's
+		/// bookkeeping for those entities.
+		std::vector<EntitySlot> entitySlots;
+		std::vector<std::size_t> freeEntitySlots;
+		FlagSet flags;
+		si::model::CollisionLayerSet collisionLayers;
+		InputState input;
+		KeyBindings keyBindings;
 	};
 }
@@ -1,27 +1,250 @@
 // SpaceInvaders.cpp : Defines the entry point for the application.
 //
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <chrono>
 #include <exception>
 #include <functional>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
 #include "Common.h"
+#include "FramePacer.h"
+#include "InputMapper.h"
+#include "InputState.h"
+#include "RandomGenerator.h"
+#include "Replay.h"
 #include "Stopwatch.h"
 #include "Scene.h"
+#include "parser/AssetCache.h"
+#include "parser/FileWatcher.h"
 #include "parser/SceneDescription.h"
+#include "view/QualityGovernor.h"
 
-/// Plays a space invaders game, as defined by the
-/// given scene. A render window is used to
-/// render the game.
-void playGame(si::Scene& scene)
+/// Prints the given asset loading progress.
+void printLoadProgress(std::size_t loadedCount, std::size_t totalCount)
 {
-	auto dims = scene.getDimensions();
+	std::cout << "\rLoading assets... " << loadedCount << "/" << totalCount << std::flush;
+	if (loadedCount == totalCount)
+		std::cout << std::endl;
+}
+
+/// Describes how a game is played, as specified
+/// on the command line.
+struct GameOptions
+{
+	/// The path of the scene description.
+	std::string scenePath;
+	/// Tells if the scene is reloaded whenever its
+	/// scene description or one of its assets changes.
+	bool isWatching;
+	/// Tells if a seed was given for the random generator.
+	/// Otherwise, the scene's seed, or a random seed, is used.
+	bool hasSeed;
+	std::uint32_t seed;
+	/// The amount of time that every frame simulates, or zero
+	/// if frames are timed by the wall clock.
+	si::duration_t fixedDelta;
+	/// The number of frames per second at which the game is
+	/// displayed, or zero if the scene decides this.
+	double frameRate;
+	/// Tells if frames are synchronized with the display's
+	/// refresh rate, instead of being paced by a frame rate.
+	bool isVsyncEnabled;
+	/// The amount of time that updating and rendering a frame
+	/// may take before the quality of visual effects is lowered,
+	/// or zero if the frame period decides this.
+	si::duration_t frameBudget;
+	/// The number of bytes that the asset cache may use
+	/// before unused assets are evicted, or zero if there
+	/// is no budget.
+	std::size_t cacheBudget;
+	/// The path that the game is recorded to, if any.
+	std::string recordPath;
+	/// The path of the replay that is played back, if any.
+	std::string replayPath;
+	/// Tells if the replay is played back without a window.
+	bool isHeadless;
+};
+
+/// Loads the scene described by the file at the given path.
+/// The random generator is seeded before the scene is read.
+/// If a file watcher is given, then it is made to watch the
+/// scene description and its assets.
+std::unique_ptr<si::Scene> loadScene(
+	const std::string& path, const GameOptions& options,
+	si::parser::FileWatcher* watcher)
+{
+	si::parser::SceneDescription description(path);
+	if (watcher != nullptr)
+	{
+		watcher->clear();
+		watcher->watch(path);
+		for (const auto& item : description.getAssetPaths())
+		{
+			watcher->watch(item);
+		}
+	}
+
+	std::uint32_t seed;
+	if (options.hasSeed)
+		seed = options.seed;
+	else if (!description.tryGetSeed(seed))
+		seed = std::random_device()();
+	si::RandomGenerator::instance.seed(seed);
+
+	return description.readScene(printLoadProgress);
+}
+
+/// Tries to replace the given scene by re-parsing the
+/// scene description at the given path. The current scene
+/// is kept if the scene description contains an error.
+void reloadScene(
+	std::unique_ptr<si::Scene>& scene, const GameOptions& options,
+	si::parser::FileWatcher& watcher, sf::RenderWindow& window)
+{
+	std::cout << "Reloading '" << options.scenePath << "'..." << std::endl;
+	try
+	{
+		// The current scene is still alive while the new
+		// one is loaded, so all assets that have not changed
+		// are taken from the asset cache.
+		scene = loadScene(options.scenePath, options, &watcher);
+	}
+	catch (si::parser::XMLParseException& ex)
+	{
+		std::cout << "The scene was not reloaded, because it is not valid XML: " << std::endl
+			<< ex.what() << std::endl;
+		return;
+	}
+	catch (si::parser::SceneDescriptionException& ex)
+	{
+		std::cout << "The scene was not reloaded, because it contains an error: " << std::endl
+			<< ex.what() << std::endl;
+		return;
+	}
+
+	window.setTitle(scene->getName());
+	auto dims = scene->getDimensions();
+	if (window.getSize() != dims)
+		window.setSize(dims);
+
+	// Don't simulate the time that was spent loading
+	// the scene.
+	(void)si::Stopwatch::instance.delta();
+}
+
+/// Checks that the given game's state matches the state
+/// that the given replay recorded. A boolean is returned
+/// that tells if this is the case.
+bool checkReplay(const si::Replay& replay, const si::model::Game& game)
+{
+	auto checksum = si::computeChecksum(game);
+	if (checksum != replay.getChecksum())
+	{
+		std::cout << "The replay diverged: its final state's checksum is " << checksum
+			<< ", but " << replay.getChecksum() << " was recorded." << std::endl;
+		return false;
+	}
+
+	std::cout << "The replay matched its recording (checksum " << checksum << ")." << std::endl;
+	return true;
+}
+
+/// Gets the amount of time between the starts of two consecutive
+/// frames. Frames that simulate a fixed amount of time are displayed
+/// at the matching frame rate. Otherwise, the frame rate from the
+/// command line, or else the scene's frame rate, is used. Zero is
+/// returned if frames should not be paced at all.
+si::duration_t getFramePeriod(
+	const GameOptions& options, const si::Scene& scene,
+	const si::Replay* playback)
+{
+	if (options.isVsyncEnabled)
+		return si::duration_t(0.0);
+	else if (playback != nullptr && !playback->getFrames().empty())
+		return playback->getDuration() / static_cast<double>(playback->getFrames().size());
+	else if (options.fixedDelta.count() > 0.0)
+		return options.fixedDelta;
+	else if (options.frameRate > 0.0)
+		return si::duration_t(1.0 / options.frameRate);
+	else if (scene.getFrameRate() > 0)
+		return si::duration_t(1.0 / scene.getFrameRate());
+	else
+		return si::duration_t(0.0);
+}
+
+/// Prints how well the given frame pacer paced
+/// its frames.
+void printPacing(const si::FramePacer& pacer)
+{
+	if (pacer.getFrameCount() == 0)
+		return;
+
+	std::cout << "Displayed " << pacer.getFrameCount() << " frames";
+	if (pacer.getFramePeriod().count() > 0.0)
+		std::cout << " at " << 1.0 / pacer.getFramePeriod().count() << " Hz";
+	std::cout << ": " << 1000.0 * pacer.getMeanFrameTime().count() << "ms per frame on average, "
+		<< 1000.0 * pacer.getJitter().count() << "ms jitter, "
+		<< 1000.0 * pacer.getMaxFrameTime().count() << "ms at most." << std::endl;
+}
+
+/// Gets the amount of time that updating and rendering a frame
+/// may take. If no budget was given on the command line, then
+/// frames may take up the entire frame period, or a sixtieth of
+/// a second if frames are not paced.
+si::duration_t getFrameBudget(const GameOptions& options, const si::FramePacer& pacer)
+{
+	if (options.frameBudget.count() > 0.0)
+		return options.frameBudget;
+	else if (pacer.getFramePeriod().count() > 0.0)
+		return pacer.getFramePeriod();
+	else
+		return si::duration_t(1.0 / 60.0);
+}
+
+/// Prints the quality levels that the given quality
+/// governor picked.
+void printQuality(const si::view::QualityGovernor& governor)
+{
+	std::cout << "Effects quality: " << 100.0 * governor.getLevel() << "% at the end, "
+		<< 100.0 * governor.getMinLevel() << "% at least." << std::endl;
+}
 
-	sf::RenderWindow w(sf::VideoMode(dims.x, dims.y), scene.getName());
+/// Plays a space invaders game, as defined by the given
+/// options. A render window is used to render the game.
+/// If a replay is given, then its frames are played back,
+/// rather than the player's input. A boolean is returned
+/// that tells if the replay, if any, was played back exactly,
+/// and to the end.
+bool playGame(const GameOptions& options, const si::Replay* playback)
+{
+	si::parser::FileWatcher watcher;
+	auto scene = loadScene(options.scenePath, options, options.isWatching ? &watcher : nullptr);
+	auto dims = scene->getDimensions();
+
+	sf::RenderWindow w(sf::VideoMode(dims.x, dims.y), scene->getName());
+	// Input is read from key events. Holding a key should
+	// not produce a stream of key presses.
+	w.setKeyRepeatEnabled(false);
+	si::InputMapper inputMapper(scene->getKeyBindings());
+
+	// The frame pacer sleeps between frames, rather than
+	// letting the game loop spin as fast as it can.
+	w.setVerticalSyncEnabled(options.isVsyncEnabled);
+	si::FramePacer pacer(getFramePeriod(options, *scene, playback));
+	// The quality governor lowers the quality of visual effects
+	// when frames take too long.
+	si::view::QualityGovernor governor(getFrameBudget(options, pacer));
+
+	si::Replay recording(si::RandomGenerator::instance.getSeed());
+	std::size_t frameIndex = 0;
 
 	(void)si::Stopwatch::instance.delta();
 
@@ -30,6 +253,7 @@ void playGame(si::Scene& scene)
 		sf::Event event;
 		while (w.pollEvent(event))
 		{
+			inputMapper.handleEvent(event);
 			if (event.type == sf::Event::Closed)
 			{
 				w.close();
@@ -41,30 +265,257 @@ void playGame(si::Scene& scene)
 			}
 		}
 
-		auto delta = si::Stopwatch::instance.delta();
+		if (options.isWatching && watcher.poll())
+		{
+			reloadScene(scene, options, watcher, w);
+			inputMapper.setBindings(scene->getKeyBindings());
+			pacer.setFramePeriod(getFramePeriod(options, *scene, playback));
+			governor.setFrameBudget(getFrameBudget(options, pacer));
+		}
+
+		si::duration_t delta;
+		si::InputState input;
+		if (playback != nullptr)
+		{
+			if (frameIndex == playback->getFrames().size())
+				break;
+
+			const auto& frame = playback->getFrames()[frameIndex++];
+			delta = frame.timeDelta;
+			input = frame.input;
+		}
+		else
+		{
+			auto wallDelta = si::Stopwatch::instance.delta();
+			delta = options.fixedDelta.count() > 0.0 ? options.fixedDelta : wallDelta;
+			input = inputMapper.nextFrame();
+			if (!options.recordPath.empty())
+				recording.addFrame(delta, input);
+		}
 
-		scene.frame(w, delta);
+		scene->setInput(input);
+		scene->setQuality(governor.getSettings());
+		// Only updating and rendering the scene is timed. Displaying
+		// the frame may block until the display is ready for it.
+		auto frameStart = std::chrono::steady_clock::now();
+		scene->frame(w, delta);
+		governor.addFrameTime(std::chrono::steady_clock::now() - frameStart);
 
 		w.display();
+		pacer.wait();
+	}
+
+	printPacing(pacer);
+	printQuality(governor);
+
+	if (!options.recordPath.empty())
+	{
+		recording.setChecksum(si::computeChecksum(scene->getGame()));
+		recording.save(options.recordPath);
+		std::cout << "Recorded " << recording.getFrames().size() << " frames to '"
+			<< options.recordPath << "'." << std::endl;
 	}
+
+	if (playback == nullptr)
+		return true;
+
+	if (frameIndex < playback->getFrames().size())
+	{
+		std::cout << "The replay is incomplete: the window was closed after "
+			<< frameIndex << " of " << playback->getFrames().size() << " frames." << std::endl;
+		return false;
+	}
+	return checkReplay(*playback, scene->getGame());
+}
+
+/// Plays back the given replay without rendering anything,
+/// as fast as possible, and reports how long that took.
+/// A boolean is returned that tells if the replay was played
+/// back exactly.
+bool runHeadless(const GameOptions& options, const si::Replay& replay)
+{
+	// Don't play any sounds.
+	sf::Listener::setGlobalVolume(0.0f);
+
+	auto scene = loadScene(options.scenePath, options, nullptr);
+
+	// Keep track of the number of live controllers. That number
+	// should not grow steadily as time goes on.
+	std::size_t peakControllerCount = 0;
+
+	auto startTime = std::chrono::steady_clock::now();
+	for (const auto& frame : replay.getFrames())
+	{
+		scene->setInput(frame.input);
+		scene->update(frame.timeDelta);
+		peakControllerCount = std::max(peakControllerCount, scene->getController().size());
+	}
+	si::duration_t wallTime = std::chrono::steady_clock::now() - startTime;
+
+	auto frameCount = replay.getFrames().size();
+	std::cout << "Simulated " << frameCount << " frames (" << replay.getDuration().count()
+		<< "s of game time) in " << wallTime.count() << "s";
+	if (frameCount > 0)
+		std::cout << ", or " << 1000.0 * wallTime.count() / frameCount << "ms per frame";
+	std::cout << "." << std::endl;
+	std::cout << "Live controllers: " << scene->getController().size()
+		<< " at the end, " << peakControllerCount << " at most." << std::endl;
+
+	return checkReplay(replay, scene->getGame());
+}
+
+/// Compiles the scene description at the given path
+/// to a binary scene file, which can be loaded
+/// without parsing any XML.
+void compileScene(const std::string& inputPath, const std::string& outputPath)
+{
+	si::parser::SceneDescription description(inputPath);
+	description.compile(outputPath);
+	std::cout << "Compiled '" << inputPath << "' to '" << outputPath << "'." << std::endl;
+}
+
+/// Parses the given command-line arguments. A boolean
+/// is returned that tells if they are valid.
+bool parseOptions(int argc, char* argv[], GameOptions& options)
+{
+	options.isWatching = false;
+	options.hasSeed = false;
+	options.seed = 0;
+	options.fixedDelta = si::duration_t(0.0);
+	options.frameRate = 0.0;
+	options.isVsyncEnabled = false;
+	options.frameBudget = si::duration_t(0.0);
+	options.cacheBudget = si::parser::AssetCache::DefaultMemoryBudget;
+	options.isHeadless = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		try
+		{
+			if (arg == "--watch")
+			{
+				options.isWatching = true;
+			}
+			else if (arg == "--headless")
+			{
+				options.isHeadless = true;
+			}
+			else if (arg == "--seed" && hasValue)
+			{
+				options.hasSeed = true;
+				options.seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+			}
+			else if (arg == "--fixed-delta" && hasValue)
+			{
+				options.fixedDelta = si::duration_t(std::stod(argv[++i]));
+				if (options.fixedDelta.count() <= 0.0)
+					return false;
+			}
+			else if (arg == "--fps" && hasValue)
+			{
+				options.frameRate = std::stod(argv[++i]);
+				if (options.frameRate <= 0.0)
+					return false;
+			}
+			else if (arg == "--vsync")
+			{
+				options.isVsyncEnabled = true;
+			}
+			else if (arg == "--frame-budget" && hasValue)
+			{
+				options.frameBudget = si::duration_t(std::stod(argv[++i]));
+				if (options.frameBudget.count() <= 0.0)
+					return false;
+			}
+			else if (arg == "--cache-budget" && hasValue)
+			{
+				// The budget is given in megabytes.
+				double budget = std::stod(argv[++i]);
+				if (budget < 0.0)
+					return false;
+				options.cacheBudget = static_cast<std::size_t>(budget * 1024 * 1024);
+			}
+			else if (arg == "--record" && hasValue)
+			{
+				options.recordPath = argv[++i];
+			}
+			else if (arg == "--replay" && hasValue)
+			{
+				options.replayPath = argv[++i];
+			}
+			else if (options.scenePath.empty() && arg.compare(0, 2, "--") != 0)
+			{
+				options.scenePath = arg;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		catch (std::logic_error&)
+		{
+			// The argument's value is not a number.
+			return false;
+		}
+	}
+
+	bool isReplaying = !options.replayPath.empty();
+	bool isRecording = !options.recordPath.empty();
+	return !options.scenePath.empty()
+		// Replays determine their own seed and time deltas.
+		&& !(isReplaying && (options.hasSeed || options.fixedDelta.count() > 0.0 || isRecording))
+		// Replays only make sense for a scene that doesn't change.
+		&& !(options.isWatching && (isReplaying || isRecording))
+		// Frames are either paced by a frame rate, or by the display.
+		&& !(options.isVsyncEnabled && options.frameRate > 0.0)
+		&& (!options.isHeadless || isReplaying);
 }
 
 int main(int argc, char* argv[])
 {
-	if (argc != 2)
+	bool isCompiling = argc == 4 && std::string(argv[1]) == "--compile";
+
+	GameOptions options;
+	if (!isCompiling && !parseOptions(argc, argv, options))
 	{
-		std::cout << "Expected exactly one argument, which refers to a scene description. "
-				  << "Got " << (argc < 2 ? "none" : std::to_string(argc - 1)) << "."
+		std::cout << "Expected a single scene description, optionally preceded by '--watch', "
+				  << "'--seed <seed>', '--fixed-delta <seconds>', '--fps <rate>', '--vsync', "
+				  << "'--frame-budget <seconds>', '--cache-budget <megabytes>', '--record <replay>', "
+				  << "or '--replay <replay>' and '--headless'; "
+				  << "or '--compile <scene> <output>'. "
+				  << "Got " << (argc < 2 ? "no arguments" : std::to_string(argc - 1) + " argument(s)") << "."
 				  << std::endl;
 		return 1;
 	}
 
 	try
 	{
-		auto scene = si::parser::parseScene(argv[1]);
+		if (isCompiling)
+		{
+			compileScene(argv[2], argv[3]);
+			return 0;
+		}
+
+		si::parser::AssetCache::instance().setMemoryBudget(options.cacheBudget);
 
-		playGame(*scene);
-		return 0;
+		if (options.replayPath.empty())
+		{
+			playGame(options, nullptr);
+			return 0;
+		}
+
+		// Replays are played back from the seed
+		// that they were recorded with.
+		auto replay = si::Replay::load(options.replayPath);
+		options.hasSeed = true;
+		options.seed = replay.getSeed();
+
+		bool isExact = options.isHeadless
+			? runHeadless(options, replay)
+			: playGame(options, &replay);
+		return isExact ? 0 : 2;
 	}
 	catch (si::parser::XMLParseException& ex)
 	{
@@ -78,4 +529,10 @@ int main(int argc, char* argv[])
 			<< ex.what() << std::endl;
 		return 1;
 	}
+	catch (si::ReplayException& ex)
+	{
+		std::cout << "The replay could not be used. To be exact: " << std::endl
+			<< ex.what() << std::endl;
+		return 1;
+	}
 }
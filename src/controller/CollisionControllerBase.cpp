@@ -36,11 +36,18 @@ void CollisionControllerBase::update(si::model::Game& game, duration_t)
 		return;
 	}
 
-	// Then, find collisions in this frame.
+	// Then, find collisions in this frame. Sweep tests are used
+	// here, so fast entities and long time steps can't make
+	// entities tunnel through each other.
 	auto curEntity = this->getEntity();
+	auto curProps = curEntity->getPhysicsProperties();
 	for (const auto& item : game.getAll<si::model::PhysicsEntity>())
 	{
-		if (item != curEntity && curEntity->overlaps(*item))
+		// Entities whose collision layers rule out a collision
+		// are rejected before any distance math is done.
+		if (item != curEntity
+			&& curProps.canCollide(item->getPhysicsProperties())
+			&& curEntity->sweptOverlaps(*item))
 		{
 			this->collisionTargets.push_back(item);
 		}
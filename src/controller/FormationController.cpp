@@ -0,0 +1,118 @@
+#include "FormationController.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "Common.h"
+#include "model/Entity.h"
+#include "model/ShipEntity.h"
+#include "model/PathDescriptor.h"
+#include "IController.h"
+
+using namespace si;
+using namespace si::controller;
+
+/// Creates a new formation controller that makes its
+/// members follow the given path.
+FormationController::FormationController(
+	const si::model::PathDescriptor& path, double springConstant)
+	: path(path), springConstant(springConstant), isDisbanded(false),
+	  time(0.0), members(), offsets()
+{ }
+
+/// Adds the given ship to this formation, which will
+/// make it follow this formation's path at the given
+/// offset.
+void FormationController::add(const std::shared_ptr<si::model::ShipEntity>& member, Vector2d offset)
+{
+	this->members.push_back(member);
+	this->offsets.push_back(offset);
+}
+
+/// Gets the position of the given offset in this
+/// formation, at the formation's current time.
+Vector2d FormationController::getPosition(Vector2d offset) const
+{
+	return this->path.evaluate(this->time) + offset;
+}
+
+/// Tests if this formation's members move rigidly,
+/// rather than being pulled along by springs.
+bool FormationController::isRigid() const
+{
+	return this->springConstant == 0.0;
+}
+
+/// Removes all members from this formation, and
+/// disbands it.
+void FormationController::disband()
+{
+	this->members.clear();
+	this->offsets.clear();
+	this->isDisbanded = true;
+}
+
+/// Checks if this controller is still "alive".
+bool FormationController::isAlive() const
+{
+	return !this->isDisbanded;
+}
+
+/// Updates the game model based on the given time delta.
+void FormationController::update(si::model::Game&, duration_t timeDelta)
+{
+	this->time += timeDelta;
+
+	// Dead members are swap-removed, along with their offsets.
+	for (std::size_t i = 0; i < this->members.size();)
+	{
+		if (this->members[i]->isAlive())
+		{
+			i++;
+		}
+		else
+		{
+			this->members[i] = this->members.back();
+			this->members.pop_back();
+			this->offsets[i] = this->offsets.back();
+			this->offsets.pop_back();
+		}
+	}
+
+	// Compute where the formation should be in the next
+	// frame. This is the only time the path is evaluated.
+	auto anchor = this->path.evaluate(this->time + timeDelta);
+
+	std::size_t count = this->members.size();
+	if (this->isRigid())
+	{
+		if (timeDelta.count() <= 0.0)
+			return;
+
+		// Give every member the velocity that takes it to
+		// its spot by the next frame. Members are not moved
+		// instantaneously, so their motion can still be swept
+		// for collisions.
+		double inverseDelta = 1.0 / timeDelta.count();
+		for (std::size_t i = 0; i < count; i++)
+		{
+			auto& member = *this->members[i];
+			auto targetPos = anchor + this->offsets[i];
+			member.accelerate((targetPos - member.getPosition()) * inverseDelta - member.getVelocity());
+		}
+	}
+	else
+	{
+		// Model a critically damped spring, like the path
+		// controller does. The damping constant is the same
+		// for every member.
+		double dampingConstant = 2 * std::sqrt(this->springConstant);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			auto& member = *this->members[i];
+			auto direction = anchor + this->offsets[i] - member.getPosition();
+			auto totalForce = this->springConstant * direction - dampingConstant * member.getVelocity();
+			member.accelerate(totalForce * timeDelta.count());
+		}
+	}
+}
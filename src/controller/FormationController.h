@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Common.h"
+#include "model/Entity.h"
+#include "model/ShipEntity.h"
+#include "model/PathDescriptor.h"
+#include "IController.h"
+
+namespace si
+{
+	namespace controller
+	{
+		/// Defines a type of controller that makes a formation
+		/// of ships follow a single path. Every member of the
+		/// formation keeps a fixed offset from the path, so the
+		/// path only needs to be evaluated once per frame for the
+		/// entire formation.
+		///
+		/// Members either move rigidly, such that they arrive at
+		/// their spot in the formation by the next frame, or are
+		/// pulled toward their spot by a critically damped spring,
+		/// which smooths out their motion.
+		class FormationController final : public IController
+		{
+		public:
+			/// Creates a new formation controller that makes its
+			/// members follow the given path. If the spring constant
+			/// is zero, then members move rigidly. Otherwise, they
+			/// are pulled toward their spot by a spring.
+			FormationController(const si::model::PathDescriptor& path, double springConstant);
+
+			/// Adds the given ship to this formation, which will
+			/// make it follow this formation's path at the given
+			/// offset.
+			void add(const std::shared_ptr<si::model::ShipEntity>& member, Vector2d offset);
+
+			/// Gets the position of the given offset in this
+			/// formation, at the formation's current time.
+			Vector2d getPosition(Vector2d offset) const;
+
+			/// Tests if this formation's members move rigidly,
+			/// rather than being pulled along by springs.
+			bool isRigid() const;
+
+			/// Removes all members from this formation, and
+			/// disbands it. The controller will then be eliminated
+			/// from the controller list.
+			void disband();
+
+			/// Checks if this controller is still "alive".
+			/// A formation stays alive until it is disbanded, even
+			/// if it has no members, so members can still be added.
+			bool isAlive() const final override;
+
+			/// Updates the game model based on the given time delta.
+			void update(si::model::Game& game, duration_t timeDelta) final override;
+		private:
+			si::model::PathDescriptor path;
+			double springConstant;
+			bool isDisbanded;
+
+			/// The amount of time that the formation has
+			/// followed its path.
+			duration_t time;
+
+			/// The formation's members. The i-th member keeps
+			/// the i-th offset from the path.
+			std::vector<std::shared_ptr<si::model::ShipEntity>> members;
+			std::vector<Vector2d> offsets;
+		};
+	}
+}
@@ -1,6 +1,8 @@
 #include "GameController.h"
 
 #include <algorithm>
+#include <memory>
+#include <unordered_set>
 #include "Container.h"
 #include "IController.h"
 
@@ -13,17 +15,18 @@ using namespace si::controller;
 bool GameController::isAlive() const
 {
 	return std::any_of(this->items.begin(), this->items.end(), 
-		[](const std::shared_ptr<IController>& x) -> bool { return x->isAlive(); });
+		[this](const std::shared_ptr<IController>& x) -> bool { return !this->isRemovable(x); });
 }
 
 /// Updates the game model based on the given time delta.
 void GameController::update(si::model::Game& game, duration_t timeDelta)
 {
-	// First, remove all dead controllers.
+	// First, remove all dead and released controllers.
 	this->items.erase(
 		std::remove_if(this->items.begin(), this->items.end(),
-			[](const std::shared_ptr<IController>& x) -> bool { return !x->isAlive(); }),
+			[this](const std::shared_ptr<IController>& x) -> bool { return this->isRemovable(x); }),
 		this->items.end());
+	this->releasedItems.clear();
 	// Create a copy of the items
 	// now, to ensure that we don't
 	// iterate-and-edit later.
@@ -33,4 +36,16 @@ void GameController::update(si::model::Game& game, duration_t timeDelta)
 	{
 		item->update(game, timeDelta);
 	}
-}
\ No newline at end of file
+}
+/// Marks the given controller as released.
+void GameController::release(const std::shared_ptr<IController>& item)
+{
+	this->releasedItems.insert(item);
+}
+
+/// Tests if the given controller should be removed.
+bool GameController::isRemovable(const std::shared_ptr<IController>& item) const
+{
+	return !item->isAlive()
+		|| (!this->releasedItems.empty() && this->releasedItems.count(item) > 0);
+}
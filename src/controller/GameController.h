@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+#include <unordered_set>
 #include "Container.h"
 #include "IController.h"
 
@@ -18,6 +20,21 @@ namespace si
 
 			/// Updates the game model based on the given time delta.
 			void update(si::model::Game& game, duration_t timeDelta) final override;
+
+			/// Marks the given controller as released. Released
+			/// controllers are removed along with dead controllers,
+			/// at the start of the next update. This is cheaper than
+			/// removing them one by one.
+			void release(const std::shared_ptr<IController>& item);
+
+		private:
+			/// Tests if the given controller should be removed.
+			bool isRemovable(const std::shared_ptr<IController>& item) const;
+
+			/// The controllers that have been released since the
+			/// last update. Holding on to them makes sure that their
+			/// addresses are not reused until they have been removed.
+			std::unordered_set<std::shared_ptr<IController>> releasedItems;
 		};
 	}
 }
\ No newline at end of file
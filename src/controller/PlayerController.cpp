@@ -1,16 +1,18 @@
 #include "PlayerController.h"
 
 #include <memory>
-#include <SFML/Window/Keyboard.hpp>
 #include "Common.h"
+#include "InputState.h"
 #include "IController.h"
 #include "model/ShipEntity.h"
 
 using namespace si;
 using namespace si::controller;
 
-PlayerController::PlayerController(const std::shared_ptr<si::model::ShipEntity>& player, double acceleration)
-	: player(player), accelConst(acceleration)
+PlayerController::PlayerController(
+	const std::shared_ptr<si::model::ShipEntity>& player, double acceleration,
+	const si::InputState& input)
+	: player(player), accelConst(acceleration), input(input)
 { }
 
 bool PlayerController::isAlive() const
@@ -25,13 +27,11 @@ void PlayerController::update(si::model::Game&, duration_t timeDelta)
 	auto right = normalizeVec(si::Vector2d(-forward.y, forward.x));
 
 	Vector2d accel;
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::W) ||
-		sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
+	if (this->input.isActive(PlayerAction::Forward))
 	{
 		accel += forward;
 	}
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::S) ||
-		sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
+	if (this->input.isActive(PlayerAction::Backward))
 	{
 		// Only go backward if that doesn't change the player ship's direction.
 
@@ -42,13 +42,11 @@ void PlayerController::update(si::model::Game&, duration_t timeDelta)
 		if (vecDot(vel + newAccel * this->accelConst * timeDelta.count() / vecLength(newAccel), vel) >= 0.0)
 			accel = newAccel;
 	}
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::A) ||
-		sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+	if (this->input.isActive(PlayerAction::Left))
 	{
 		accel -= right;
 	}
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::D) ||
-		sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+	if (this->input.isActive(PlayerAction::Right))
 	{
 		accel += right;
 	}
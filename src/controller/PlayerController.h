@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "InputState.h"
 #include "IController.h"
 #include "model/ShipEntity.h"
 
@@ -9,16 +10,19 @@ namespace si
 	namespace controller
 	{
 		/// A controller class for the player's ship.
-		/// Player controllers convert keyboard input
+		/// Player controllers convert the player's input
 		/// into changes to the game world.
 		class PlayerController final : public IController
 		{
 		public:
-			/// Creates a player controller from the given player and
-			/// acceleration multiplier.
+			/// Creates a player controller from the given player,
+			/// acceleration multiplier and input state. The input
+			/// state is read on every update, and must outlive
+			/// the player controller.
 			PlayerController(
 				const std::shared_ptr<si::model::ShipEntity>& player,
-				double acceleration);
+				double acceleration,
+				const si::InputState& input);
 
 			/// Checks if this player controller is still alive.
 			bool isAlive() const final override;
@@ -30,6 +34,8 @@ namespace si
 			const std::shared_ptr<si::model::ShipEntity> player;
 			/// An acceleration multiplier.
 			const double accelConst;
+			/// The input state, which is sampled once per frame.
+			const si::InputState& input;
 		};
 	}
 }
@@ -0,0 +1,50 @@
+#include "CollisionLayers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+using namespace si;
+using namespace si::model;
+
+const char* const CollisionLayerSet::DefaultLayerName = "default";
+const CollisionMask CollisionLayerSet::DefaultLayer = 1;
+const CollisionMask CollisionLayerSet::AllLayers = ~CollisionMask(0);
+const std::size_t CollisionLayerSet::MaxLayerCount = 32;
+
+/// Creates a collision layer set that only contains
+/// the default layer.
+CollisionLayerSet::CollisionLayerSet()
+	: layers()
+{
+	this->layers[DefaultLayerName] = DefaultLayer;
+}
+
+/// Tries to get the bit of the layer with the given
+/// name. If no such layer exists yet, then it is
+/// created.
+bool CollisionLayerSet::tryIntern(const std::string& name, CollisionMask& result)
+{
+	auto pos = this->layers.find(name);
+	if (pos != this->layers.end())
+	{
+		result = pos->second;
+		return true;
+	}
+
+	if (this->layers.size() == MaxLayerCount)
+		return false;
+
+	// Layers are assigned bits in the order in
+	// which they are created.
+	result = CollisionMask(1) << this->layers.size();
+	this->layers[name] = result;
+	return true;
+}
+
+/// Gets the number of layers in this set.
+std::size_t CollisionLayerSet::size() const
+{
+	return this->layers.size();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace si
+{
+	namespace model
+	{
+		/// A set of collision layers, where every layer
+		/// is represented by a single bit.
+		typedef std::uint32_t CollisionMask;
+
+		/// Defines a set of named collision layers. Layer names
+		/// are interned to bits, so sets of layers can be stored
+		/// as bit masks, and compared without any lookups.
+		class CollisionLayerSet final
+		{
+		public:
+			/// Creates a collision layer set that only contains
+			/// the default layer.
+			CollisionLayerSet();
+
+			/// Tries to get the bit of the layer with the given
+			/// name. If no such layer exists yet, then it is
+			/// created. A boolean is returned that tells if this
+			/// succeeded: there can be at most MaxLayerCount layers.
+			bool tryIntern(const std::string& name, CollisionMask& result);
+
+			/// Gets the number of layers in this set.
+			std::size_t size() const;
+
+			/// The name of the layer that entities are in if
+			/// they don't specify a layer.
+			static const char* const DefaultLayerName;
+
+			/// The bit of the default layer.
+			static const CollisionMask DefaultLayer;
+
+			/// A mask that contains every layer.
+			static const CollisionMask AllLayers;
+
+			/// The maximal number of layers in a set.
+			static const std::size_t MaxLayerCount;
+
+		private:
+			std::unordered_map<std::string, CollisionMask> layers;
+		};
+	}
+}
@@ -31,6 +31,8 @@ Vector2d DriftingEntity::getPosition() const
 void DriftingEntity::setPosition(Vector2d pos)
 {
 	this->prevPos = pos;
+	// The entity didn't travel to its new position.
+	this->resetSweep();
 }
 
 void DriftingEntity::accelerate(Vector2d velocity)
@@ -42,6 +44,7 @@ void DriftingEntity::accelerate(Vector2d velocity)
 
 void DriftingEntity::updateTime(duration_t delta)
 {
+	this->beginSweep();
 	this->Entity::updateTime(delta);
 
 	this->prevPos += delta.count() * this->getVelocity();
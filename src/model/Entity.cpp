@@ -1,10 +1,13 @@
 #include "Entity.h"
 
+#include <cstddef>
 #include "Common.h"
 
 using namespace si;
 using namespace si::model;
 
+const std::size_t Entity::NoSlot = static_cast<std::size_t>(-1);
+
 void Entity::updateTime(duration_t delta)
 {
 	elapsed += delta;
@@ -15,3 +18,12 @@ duration_t Entity::getLifetime() const
 	return elapsed;
 }
 
+std::size_t Entity::getSlot() const
+{
+	return slot;
+}
+
+void Entity::setSlot(std::size_t slot)
+{
+	this->slot = slot;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include "Common.h"
 
@@ -30,8 +31,22 @@ namespace si
 			/// i.e. the number of seconds that have elapsed
 			/// since its creation.
 			duration_t getLifetime() const;
+
+			/// Gets the compact slot index that the scene which
+			/// contains this entity has assigned to it, or NoSlot
+			/// if the entity has not been assigned a slot.
+			std::size_t getSlot() const;
+
+			/// Sets this entity's slot index. This is managed
+			/// by the scene which contains this entity.
+			void setSlot(std::size_t slot);
+
+			/// A slot index that indicates that an entity
+			/// has not been assigned a slot.
+			static const std::size_t NoSlot;
 		private:
 			duration_t elapsed{ 0.0 };
+			std::size_t slot{ NoSlot };
 		};
 
 		typedef std::shared_ptr<Entity> Entity_ptr;
@@ -3,12 +3,26 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cstddef>
+#include <unordered_map>
 #include "Common.h"
 #include "Entity.h"
 
 using namespace si;
 using namespace si::model;
 
+/// Creates an empty game.
+Game::Game()
+	: boundsConstraints(), boundsConstraintIndices(), escapees()
+{
+	// Entities that are removed from the game don't
+	// need to be kept within their bounds anymore.
+	this->registerRemoveHandler([this](const Entity_ptr& item)
+	{
+		this->removeBoundsConstraint(*item);
+	});
+}
+
 /// Gets the game's origin.
 Vector2d Game::getPosition() const
 {
@@ -18,7 +32,8 @@ Vector2d Game::getPosition() const
 /// Adds the given time delta to the total amount 
 /// of time elapsed.
 /// This will recursively update all entities in the
-/// game.
+/// game. Entities that have left their bounds are
+/// then removed from the game.
 void Game::updateTime(duration_t delta)
 {
 	this->Entity::updateTime(delta);
@@ -27,4 +42,86 @@ void Game::updateTime(duration_t delta)
 	{
 		item->updateTime(delta);
 	}
-}
\ No newline at end of file
+
+	this->removeEscapees();
+}
+
+/// Constrains the given entity to the given bounds
+/// (in relative coordinates). Once exceeded, the entity
+/// is removed from the game.
+void Game::addBoundsConstraint(const Entity_ptr& entity, DoubleRect bounds)
+{
+	auto pos = this->boundsConstraintIndices.find(entity.get());
+	if (pos != this->boundsConstraintIndices.end())
+	{
+		this->boundsConstraints[pos->second].bounds = bounds;
+	}
+	else
+	{
+		this->boundsConstraintIndices[entity.get()] = this->boundsConstraints.size();
+		this->boundsConstraints.push_back(BoundsConstraint { entity, bounds });
+	}
+}
+
+/// Gets the number of entities that are constrained
+/// to bounds.
+std::size_t Game::getBoundsConstraintCount() const
+{
+	return this->boundsConstraints.size();
+}
+
+/// Removes the given entity's bounds constraint,
+/// if it has one.
+void Game::removeBoundsConstraint(const Entity& entity)
+{
+	auto pos = this->boundsConstraintIndices.find(&entity);
+	if (pos == this->boundsConstraintIndices.end())
+		return;
+
+	// Move the last constraint into the removed
+	// constraint's slot.
+	auto index = pos->second;
+	this->boundsConstraintIndices.erase(pos);
+	if (index + 1 != this->boundsConstraints.size())
+	{
+		this->boundsConstraints[index] = std::move(this->boundsConstraints.back());
+		this->boundsConstraintIndices[this->boundsConstraints[index].entity.get()] = index;
+	}
+	this->boundsConstraints.pop_back();
+}
+
+/// Removes all entities that have left their bounds
+/// from the game, in a single batch.
+void Game::removeEscapees()
+{
+	for (const auto& item : this->boundsConstraints)
+	{
+		if (!item.bounds.contains(item.entity->getPosition()))
+			this->escapees.push_back(item.entity);
+	}
+
+	if (this->escapees.empty())
+		return;
+
+	// There are usually only a handful of escapees, so
+	// a binary search is cheaper than hashing every
+	// entity in the game.
+	auto compare = [](const Entity_ptr& left, const Entity_ptr& right) -> bool
+	{
+		return left.get() < right.get();
+	};
+	std::sort(this->escapees.begin(), this->escapees.end(), compare);
+	this->removeAll([&](const Entity_ptr& item) -> bool
+	{
+		return std::binary_search(this->escapees.begin(), this->escapees.end(), item, compare);
+	});
+
+	// The remove handler has dropped the escapees' constraints,
+	// except for escapees that weren't in the game to begin with.
+	// The scratch buffer keeps the escapees alive until then.
+	for (const auto& item : this->escapees)
+	{
+		this->removeBoundsConstraint(*item);
+	}
+	this->escapees.clear();
+}
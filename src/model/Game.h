@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
 #include "Common.h"
 #include "Entity.h"
 #include "Container.h"
@@ -12,14 +15,61 @@ namespace si
 		class Game final : public Container<Entity>, public virtual Entity
 		{
 		public:
+			/// Creates an empty game.
+			Game();
+
+			Game(const Game&) = delete;
+
 			/// Gets the game's origin.
 			Vector2d getPosition() const final override;
 
 			/// Adds the given time delta to the total amount 
 			/// of time elapsed.
 			/// This will recursively update all entities in the
-			/// game.
+			/// game. Entities that have left their bounds are
+			/// then removed from the game.
 			void updateTime(duration_t delta) final override;
+
+			/// Constrains the given entity to the given bounds
+			/// (in relative coordinates). Once exceeded, the entity
+			/// is removed from the game. An entity has at most one
+			/// bounds constraint: constraining an entity again
+			/// replaces its bounds.
+			void addBoundsConstraint(const Entity_ptr& entity, DoubleRect bounds);
+
+			/// Gets the number of entities that are constrained
+			/// to bounds.
+			std::size_t getBoundsConstraintCount() const;
+
+		private:
+			/// Describes an entity that is constrained to bounds.
+			struct BoundsConstraint
+			{
+				Entity_ptr entity;
+				DoubleRect bounds;
+			};
+
+			/// Removes the given entity's bounds constraint,
+			/// if it has one.
+			void removeBoundsConstraint(const Entity& entity);
+
+			/// Removes all entities that have left their bounds
+			/// from the game, in a single batch.
+			void removeEscapees();
+
+			/// The bounds constraints, stored contiguously, so they
+			/// can be checked in a single loop.
+			std::vector<BoundsConstraint> boundsConstraints;
+
+			/// Maps entities to the indices of their bounds
+			/// constraints.
+			std::unordered_map<const Entity*, std::size_t> boundsConstraintIndices;
+
+			/// A scratch buffer for the entities that have left
+			/// their bounds, which is kept around to avoid
+			/// allocating it every frame. It holds on to the
+			/// escapees until they have been fully removed.
+			std::vector<Entity_ptr> escapees;
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,244 @@
+#include "PathDescriptor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include "Common.h"
+
+using namespace si;
+using namespace si::model;
+
+/// Creates a path descriptor that stays at the origin.
+PathDescriptor::PathDescriptor()
+	: kind(PathKind::Linear), origin(), velocity(),
+	  sineAxis(), cosineAxis(), frequency(0.0), phase(0.0),
+	  controlPoints(), splineDuration(0.0)
+{ }
+
+/// Creates a linear path that starts at the given origin,
+/// and moves at the given velocity.
+PathDescriptor PathDescriptor::linear(Vector2d origin, Vector2d velocity)
+{
+	PathDescriptor result;
+	result.kind = PathKind::Linear;
+	result.origin = origin;
+	result.velocity = velocity;
+	return result;
+}
+
+/// Creates a path that moves at the given velocity, while
+/// weaving along the given amplitude vector at the given
+/// angular frequency.
+PathDescriptor PathDescriptor::weave(
+	Vector2d origin, Vector2d velocity, Vector2d amplitude,
+	double frequency, double phase)
+{
+	PathDescriptor result;
+	result.kind = PathKind::Weave;
+	result.origin = origin;
+	result.velocity = velocity;
+	result.sineAxis = amplitude;
+	result.frequency = frequency;
+	result.phase = phase;
+	return result;
+}
+
+/// Creates a path that orbits the given center, with
+/// the given radius and angular velocity.
+PathDescriptor PathDescriptor::orbit(
+	Vector2d center, double radius,
+	double angularVelocity, double phase)
+{
+	PathDescriptor result;
+	result.kind = PathKind::Orbit;
+	result.origin = center;
+	result.cosineAxis = Vector2d(radius, 0.0);
+	result.sineAxis = Vector2d(0.0, radius);
+	result.frequency = angularVelocity;
+	result.phase = phase;
+	return result;
+}
+
+/// Creates a cubic Bezier spline path that is traced over
+/// the given duration.
+PathDescriptor PathDescriptor::spline(
+	Vector2d start, Vector2d firstControl,
+	Vector2d secondControl, Vector2d end,
+	duration_t duration)
+{
+	PathDescriptor result;
+	result.kind = PathKind::Spline;
+	result.origin = start;
+	result.controlPoints[0] = start;
+	result.controlPoints[1] = firstControl;
+	result.controlPoints[2] = secondControl;
+	result.controlPoints[3] = end;
+	result.splineDuration = duration.count();
+	return result;
+}
+
+/// Evaluates this path at the given point in time.
+Vector2d PathDescriptor::evaluate(duration_t time) const
+{
+	double t = time.count();
+	switch (this->kind)
+	{
+	case PathKind::Linear:
+		return this->origin + t * this->velocity;
+
+	case PathKind::Spline:
+	{
+		double u = this->splineDuration > 0.0
+			? std::min(std::max(t / this->splineDuration, 0.0), 1.0)
+			: 1.0;
+		double v = 1.0 - u;
+		return v * v * v * this->controlPoints[0]
+			+ 3.0 * v * v * u * this->controlPoints[1]
+			+ 3.0 * v * u * u * this->controlPoints[2]
+			+ u * u * u * this->controlPoints[3];
+	}
+
+	default:
+	{
+		double angle = this->frequency * t + this->phase;
+		return this->origin + t * this->velocity
+			+ std::sin(angle) * this->sineAxis
+			+ std::cos(angle) * this->cosineAxis;
+	}
+	}
+}
+
+/// Creates an empty path batch.
+PathBatch::PathBatch()
+	: originX(), originY(), velocityX(), velocityY(),
+	  sineX(), sineY(), cosineX(), cosineY(),
+	  frequency(), phase(), splines()
+{ }
+
+/// Gets the number of paths in this batch.
+std::size_t PathBatch::size() const
+{
+	return this->originX.size();
+}
+
+/// Appends the given path to this batch, and returns
+/// its index.
+std::size_t PathBatch::add(const PathDescriptor& path)
+{
+	std::size_t index = this->size();
+	bool isSpline = path.kind == PathKind::Spline;
+
+	// Spline paths get all-zero harmonic coefficients. Their
+	// positions are patched up after the harmonic kernel has run.
+	this->originX.push_back(isSpline ? 0.0 : path.origin.x);
+	this->originY.push_back(isSpline ? 0.0 : path.origin.y);
+	this->velocityX.push_back(isSpline ? 0.0 : path.velocity.x);
+	this->velocityY.push_back(isSpline ? 0.0 : path.velocity.y);
+	this->sineX.push_back(isSpline ? 0.0 : path.sineAxis.x);
+	this->sineY.push_back(isSpline ? 0.0 : path.sineAxis.y);
+	this->cosineX.push_back(isSpline ? 0.0 : path.cosineAxis.x);
+	this->cosineY.push_back(isSpline ? 0.0 : path.cosineAxis.y);
+	this->frequency.push_back(isSpline ? 0.0 : path.frequency);
+	this->phase.push_back(isSpline ? 0.0 : path.phase);
+
+	if (isSpline)
+		this->splines.emplace_back(index, path);
+
+	return index;
+}
+
+/// Removes the path at the given index by moving the
+/// last path in the batch into its slot.
+void PathBatch::swapRemove(std::size_t index)
+{
+	std::size_t last = this->size() - 1;
+	for (auto column : { &this->originX, &this->originY, &this->velocityX, &this->velocityY,
+		&this->sineX, &this->sineY, &this->cosineX, &this->cosineY,
+		&this->frequency, &this->phase })
+	{
+		(*column)[index] = (*column)[last];
+		column->pop_back();
+	}
+
+	this->splines.erase(std::remove_if(this->splines.begin(), this->splines.end(),
+		[=](const std::pair<std::size_t, PathDescriptor>& item) -> bool
+		{
+			return item.first == index;
+		}), this->splines.end());
+	for (auto& item : this->splines)
+	{
+		if (item.first == last)
+			item.first = index;
+	}
+}
+
+/// Removes a range of paths from this batch, preserving the
+/// order of the remaining paths.
+void PathBatch::erase(std::size_t first, std::size_t count)
+{
+	for (auto column : { &this->originX, &this->originY, &this->velocityX, &this->velocityY,
+		&this->sineX, &this->sineY, &this->cosineX, &this->cosineY,
+		&this->frequency, &this->phase })
+	{
+		column->erase(column->begin() + first, column->begin() + first + count);
+	}
+
+	this->splines.erase(std::remove_if(this->splines.begin(), this->splines.end(),
+		[=](const std::pair<std::size_t, PathDescriptor>& item) -> bool
+		{
+			return item.first >= first && item.first < first + count;
+		}), this->splines.end());
+	for (auto& item : this->splines)
+	{
+		if (item.first >= first + count)
+			item.first -= count;
+	}
+}
+
+/// Removes all paths from this batch.
+void PathBatch::clear()
+{
+	this->erase(0, this->size());
+}
+
+/// Evaluates every path in this batch. The i-th path is
+/// evaluated at times[i], and its position is stored
+/// in results[i].
+void PathBatch::evaluate(const double* times, Vector2d* results) const
+{
+	std::size_t count = this->size();
+
+	// Grab raw pointers up front, so the compiler doesn't
+	// have to assume that the result stores alias the
+	// coefficient arrays' bookkeeping.
+	const double* originX = this->originX.data();
+	const double* originY = this->originY.data();
+	const double* velocityX = this->velocityX.data();
+	const double* velocityY = this->velocityY.data();
+	const double* sineX = this->sineX.data();
+	const double* sineY = this->sineY.data();
+	const double* cosineX = this->cosineX.data();
+	const double* cosineY = this->cosineY.data();
+	const double* frequency = this->frequency.data();
+	const double* phase = this->phase.data();
+
+	// This is the harmonic kernel. It has no branches, and
+	// every iteration is independent of every other iteration.
+	for (std::size_t i = 0; i < count; i++)
+	{
+		double t = times[i];
+		double angle = frequency[i] * t + phase[i];
+		double s = std::sin(angle);
+		double c = std::cos(angle);
+		results[i].x = originX[i] + velocityX[i] * t + sineX[i] * s + cosineX[i] * c;
+		results[i].y = originY[i] + velocityY[i] * t + sineY[i] * s + cosineY[i] * c;
+	}
+
+	for (const auto& item : this->splines)
+	{
+		results[item.first] = item.second.evaluate(duration_t(times[item.first]));
+	}
+}
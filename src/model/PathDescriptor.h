@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Common.h"
+
+namespace si
+{
+	namespace model
+	{
+		/// Enumerates the kinds of paths that a path
+		/// descriptor can describe.
+		enum class PathKind
+		{
+			/// A straight line, traced at a constant velocity.
+			Linear,
+			/// A straight line with a sine wave superimposed on it.
+			Weave,
+			/// A circle (or ellipse) around a center point.
+			Orbit,
+			/// A cubic Bezier spline, traced over a fixed duration.
+			Spline
+		};
+
+		/// A plain-old-data description of a path. Linear, weave and
+		/// orbit paths are all instances of the same harmonic formula:
+		///
+		///     origin + velocity * t + sineAxis * sin(frequency * t + phase)
+		///            + cosineAxis * cos(frequency * t + phase)
+		///
+		/// which allows them to be evaluated by a single branch-free kernel.
+		/// Spline paths use the control points instead.
+		struct PathDescriptor
+		{
+			/// Creates a path descriptor that stays at the origin.
+			PathDescriptor();
+
+			/// Creates a linear path that starts at the given origin,
+			/// and moves at the given velocity.
+			static PathDescriptor linear(Vector2d origin, Vector2d velocity);
+
+			/// Creates a path that moves at the given velocity, while
+			/// weaving along the given amplitude vector at the given
+			/// angular frequency.
+			static PathDescriptor weave(
+				Vector2d origin, Vector2d velocity, Vector2d amplitude,
+				double frequency, double phase = 0.0);
+
+			/// Creates a path that orbits the given center, with
+			/// the given radius and angular velocity.
+			static PathDescriptor orbit(
+				Vector2d center, double radius,
+				double angularVelocity, double phase = 0.0);
+
+			/// Creates a cubic Bezier spline path that is traced over
+			/// the given duration. The path stays at the final control
+			/// point once that duration has elapsed.
+			static PathDescriptor spline(
+				Vector2d start, Vector2d firstControl,
+				Vector2d secondControl, Vector2d end,
+				duration_t duration);
+
+			/// Evaluates this path at the given point in time.
+			Vector2d evaluate(duration_t time) const;
+
+			/// This path's kind.
+			PathKind kind;
+
+			/// The harmonic path's origin.
+			Vector2d origin;
+
+			/// The harmonic path's constant velocity.
+			Vector2d velocity;
+
+			/// The axis that is scaled by the sine term.
+			Vector2d sineAxis;
+
+			/// The axis that is scaled by the cosine term.
+			Vector2d cosineAxis;
+
+			/// The angular frequency of the harmonic terms.
+			double frequency;
+
+			/// The phase of the harmonic terms.
+			double phase;
+
+			/// The spline path's control points.
+			Vector2d controlPoints[4];
+
+			/// The amount of time it takes to trace the spline path,
+			/// in seconds.
+			double splineDuration;
+		};
+
+		/// Stores a batch of path descriptors as a structure of arrays,
+		/// such that the positions of all paths in the batch can be
+		/// evaluated by a single tight loop.
+		class PathBatch final
+		{
+		public:
+			/// Creates an empty path batch.
+			PathBatch();
+
+			/// Gets the number of paths in this batch.
+			std::size_t size() const;
+
+			/// Appends the given path to this batch, and returns
+			/// its index.
+			std::size_t add(const PathDescriptor& path);
+
+			/// Removes the path at the given index by moving the
+			/// last path in the batch into its slot.
+			void swapRemove(std::size_t index);
+
+			/// Removes a range of paths from this batch, preserving the
+			/// order of the remaining paths.
+			void erase(std::size_t first, std::size_t count);
+
+			/// Removes all paths from this batch.
+			void clear();
+
+			/// Evaluates every path in this batch. The i-th path is
+			/// evaluated at times[i], and its position is stored
+			/// in results[i].
+			void evaluate(const double* times, Vector2d* results) const;
+
+		private:
+			std::vector<double> originX, originY;
+			std::vector<double> velocityX, velocityY;
+			std::vector<double> sineX, sineY;
+			std::vector<double> cosineX, cosineY;
+			std::vector<double> frequency, phase;
+
+			/// Spline paths are rare, so they are stored separately
+			/// from the harmonic coefficients, along with their index.
+			std::vector<std::pair<std::size_t, PathDescriptor>> splines;
+		};
+	}
+}
@@ -5,14 +5,22 @@
 #include "Common.h"
 #include "Entity.h"
 #include "PhysicsEntity.h"
+#include "PathDescriptor.h"
 
 using namespace si::model;
 
 PathEntity::PathEntity(PhysicsProperties physProps, PathFunction path)
-	: PhysicsEntity(physProps), path(path)
+	: PhysicsEntity(physProps), path(), pathFunction(path)
+{ }
+
+PathEntity::PathEntity(PhysicsProperties physProps, const PathDescriptor& path)
+	: PhysicsEntity(physProps), path(path), pathFunction()
 { }
 
 sf::Vector2<double> PathEntity::getPosition() const
 {
-	return path(getLifetime());
-}
\ No newline at end of file
+	if (this->pathFunction)
+		return this->pathFunction(getLifetime());
+	else
+		return this->path.evaluate(getLifetime());
+}
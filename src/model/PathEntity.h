@@ -4,6 +4,7 @@
 #include "Common.h"
 #include "Entity.h"
 #include "PhysicsEntity.h"
+#include "PathDescriptor.h"
 
 namespace si
 {
@@ -12,8 +13,8 @@ namespace si
 		typedef std::function<sf::Vector2<double>(duration_t)> PathFunction;
 
 		/// Defines a type of entity whose position is defined
-		/// by a path function. This type of entity also has physics 
-		/// properties.
+		/// by a path descriptor or, failing that, a path function.
+		/// This type of entity also has physics properties.
 		class PathEntity : public PhysicsEntity
 		{
 		public:
@@ -21,10 +22,15 @@ namespace si
 			/// properties and path function.
 			PathEntity(PhysicsProperties physProps, PathFunction path);
 
+			/// Creates a new path entity from the given physics
+			/// properties and path descriptor.
+			PathEntity(PhysicsProperties physProps, const PathDescriptor& path);
+
 			/// Gets this path entity's position.
 			virtual Vector2d getPosition() const override;
 		private:
-			PathFunction path;
+			PathDescriptor path;
+			PathFunction pathFunction;
 		};
 	}
 }
@@ -11,7 +11,7 @@ using namespace si::model;
 /// Creates a new physics entity from the given physics
 /// properties.
 PhysicsEntity::PhysicsEntity(PhysicsProperties props)
-	: physProps(props)
+	: physProps(props), hasSweepOrigin(false)
 { }
 
 Vector2d PhysicsEntity::getVelocity() const
@@ -65,8 +65,54 @@ bool PhysicsEntity::overlaps(const PhysicsEntity& other) const
 	return distSquared < totalRadius * totalRadius;
 }
 
+/// Checks if this physics entity has overlapped with
+/// the given other entity at any point during the most
+/// recent time step.
+bool PhysicsEntity::sweptOverlaps(const PhysicsEntity& other) const
+{
+	// Work in the other entity's frame of reference. The
+	// distance between both entities then varies linearly
+	// over the time step, from startDelta to endDelta.
+	auto startDelta = this->getSweepOrigin() - other.getSweepOrigin();
+	auto endDelta = this->getPosition() - other.getPosition();
+	auto motion = endDelta - startDelta;
+
+	// Find the point in time (as a fraction of the time step)
+	// where both entities were closest to each other.
+	double motionSquared = vecLengthSqr(motion);
+	double t = motionSquared > 0.0
+		? std::min(std::max(-vecDot(startDelta, motion) / motionSquared, 0.0), 1.0)
+		: 1.0;
+
+	double distSquared = vecLengthSqr(startDelta + t * motion);
+	double totalRadius = this->getPhysicsProperties().radius + other.getPhysicsProperties().radius;
+	return distSquared < totalRadius * totalRadius;
+}
+
+/// Gets the position this physics entity was at
+/// at the start of the most recent time step.
+Vector2d PhysicsEntity::getSweepOrigin() const
+{
+	return this->hasSweepOrigin ? this->sweepOrigin : this->getPosition();
+}
+
+/// Marks this physics entity's current position as
+/// the start of its sweep for the current time step.
+void PhysicsEntity::beginSweep()
+{
+	this->sweepOrigin = this->getPosition();
+	this->hasSweepOrigin = true;
+}
+
+/// Discards this physics entity's sweep.
+void PhysicsEntity::resetSweep()
+{
+	this->hasSweepOrigin = false;
+}
+
 void PhysicsEntity::updateTime(duration_t delta)
 {
+	this->beginSweep();
 	this->Entity::updateTime(delta);
 
 	// Update the physics entity's velocity
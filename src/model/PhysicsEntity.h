@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "CollisionLayers.h"
 #include "Entity.h"
 
 namespace si
@@ -14,13 +15,29 @@ namespace si
 			/// Creates a new set of physics properties
 			/// from the given information.
 			PhysicsProperties(double mass, double radius)
-				: mass(mass), radius(radius)
+				: mass(mass), radius(radius),
+				  collisionLayers(CollisionLayerSet::DefaultLayer),
+				  collisionMask(CollisionLayerSet::AllLayers)
 			{ }
 
+			/// Tests if objects with these physics properties
+			/// can collide with objects that have the given
+			/// physics properties. Both objects must be in a
+			/// layer that the other collides with.
+			bool canCollide(const PhysicsProperties& other) const
+			{
+				return (this->collisionLayers & other.collisionMask) != 0
+					&& (other.collisionLayers & this->collisionMask) != 0;
+			}
+
 			/// The object's mass.
 			double mass;
 			/// The object's radius.
 			double radius;
+			/// The collision layers that the object is in.
+			CollisionMask collisionLayers;
+			/// The collision layers that the object collides with.
+			CollisionMask collisionMask;
 		};
 
 		/// Defines an entity that has a set of
@@ -41,6 +58,21 @@ namespace si
 			/// collision detection.
 			bool overlaps(const PhysicsEntity& other) const;
 
+			/// Checks if this physics entity has overlapped with
+			/// the given other entity at any point during the most
+			/// recent time step. Both entities are assumed to have
+			/// moved in a straight line from their sweep origins to
+			/// their current positions. Unlike overlaps, this will
+			/// not let fast entities tunnel through each other.
+			bool sweptOverlaps(const PhysicsEntity& other) const;
+
+			/// Gets the position this physics entity was at
+			/// at the start of the most recent time step. If no
+			/// time step has been taken since this entity was
+			/// created or moved, then its current position is
+			/// returned.
+			Vector2d getSweepOrigin() const;
+
 			/// Gets this physics entity's velocity.
 			Vector2d getVelocity() const;
 
@@ -71,6 +103,17 @@ namespace si
 			/// the given value.
 			void setVelocity(Vector2d value);
 
+			/// Marks this physics entity's current position as
+			/// the start of its sweep for the current time step.
+			/// This should be called right before the entity's
+			/// position is updated.
+			void beginSweep();
+
+			/// Discards this physics entity's sweep, for example
+			/// because it was moved to a different location
+			/// instantaneously, rather than over time.
+			void resetSweep();
+
 			// The physics entity's previous position.
 			Vector2d prevPos;
 
@@ -80,6 +123,13 @@ namespace si
 
 			// The physics entity's velocity.
 			Vector2d velocity;
+
+			// The physics entity's position at the start
+			// of the most recent time step.
+			Vector2d sweepOrigin;
+
+			// Tells if the sweep origin is valid.
+			bool hasSweepOrigin;
 		};
 	}
 }
\ No newline at end of file
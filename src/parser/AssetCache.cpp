@@ -0,0 +1,292 @@
+#include "AssetCache.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include "FileWatcher.h"
+#include "SceneDescription.h"
+
+using namespace si;
+using namespace si::parser;
+
+namespace
+{
+	/// A font, along with the file contents that it
+	/// is loaded from. SFML reads fonts lazily, so the
+	/// contents must outlive the font.
+	struct FontData
+	{
+		std::shared_ptr<const std::vector<char>> contents;
+		sf::Font font;
+	};
+
+	/// A music object, along with the file contents
+	/// that it streams from.
+	struct MusicData
+	{
+		std::shared_ptr<const std::vector<char>> contents;
+		sf::Music music;
+	};
+}
+
+const std::size_t AssetCache::DefaultMemoryBudget = 64 * 1024 * 1024;
+
+AssetCache::AssetCache()
+	: entries(), useOrder(), memoryBudget(DefaultMemoryBudget), memoryUsage(0)
+{ }
+
+/// Gets the one and only asset cache.
+AssetCache& AssetCache::instance()
+{
+	// The cache is a function-local static, rather than a static
+	// member, because it owns SFML resources. Those must be destroyed
+	// before SFML's own globals are.
+	static AssetCache result;
+	return result;
+}
+
+/// Gets the canonical version of the given path.
+std::string AssetCache::getCanonicalPath(const std::string& path)
+{
+#ifdef _WIN32
+	char* resolved = _fullpath(nullptr, path.c_str(), 0);
+#else
+	char* resolved = realpath(path.c_str(), nullptr);
+#endif
+	if (resolved == nullptr)
+		return path;
+
+	std::string result(resolved);
+	std::free(resolved);
+	return result;
+}
+
+/// Finds the texture that was loaded from the given path.
+std::shared_ptr<sf::Texture> AssetCache::findTexture(const std::string& path)
+{
+	return std::static_pointer_cast<sf::Texture>(
+		this->find(AssetKey(AssetKind::Texture, getCanonicalPath(path))));
+}
+
+/// Adds the given texture, which was loaded from the given
+/// path, to the cache.
+void AssetCache::insertTexture(const std::string& path, const std::shared_ptr<sf::Texture>& texture)
+{
+	auto size = texture->getSize();
+	// Textures are stored as 32-bit RGBA.
+	this->insert(
+		AssetKey(AssetKind::Texture, getCanonicalPath(path)), texture,
+		static_cast<std::size_t>(size.x) * size.y * 4);
+}
+
+/// Finds the sound buffer that was loaded from the given path.
+std::shared_ptr<sf::SoundBuffer> AssetCache::findSound(const std::string& path)
+{
+	return std::static_pointer_cast<sf::SoundBuffer>(
+		this->find(AssetKey(AssetKind::Sound, getCanonicalPath(path))));
+}
+
+/// Adds the given sound buffer, which was loaded from the
+/// given path, to the cache.
+void AssetCache::insertSound(const std::string& path, const std::shared_ptr<sf::SoundBuffer>& sound)
+{
+	this->insert(
+		AssetKey(AssetKind::Sound, getCanonicalPath(path)), sound,
+		static_cast<std::size_t>(sound->getSampleCount()) * sizeof(sf::Int16));
+}
+
+/// Loads the font at the given path, or gets it from the
+/// cache.
+std::shared_ptr<sf::Font> AssetCache::loadFont(const std::string& path)
+{
+	AssetKey key(AssetKind::Font, getCanonicalPath(path));
+	auto cached = this->find(key);
+	if (cached != nullptr)
+		return std::static_pointer_cast<sf::Font>(cached);
+
+	auto data = std::make_shared<FontData>();
+	data->contents = readFile(key.second);
+	if (data->contents == nullptr
+		|| !data->font.loadFromMemory(data->contents->data(), data->contents->size()))
+	{
+		throw SceneDescriptionException("Couldn't load font file '" + path + "'.");
+	}
+
+	// Hand out a pointer to the font that keeps its
+	// contents alive.
+	std::shared_ptr<sf::Font> result(data, &data->font);
+	this->insert(key, result, data->contents->size());
+	return result;
+}
+
+/// Opens the music at the given path.
+std::shared_ptr<sf::Music> AssetCache::openMusic(const std::string& path)
+{
+	auto contents = this->readCachedFile(AssetKey(AssetKind::Music, getCanonicalPath(path)));
+
+	auto data = std::make_shared<MusicData>();
+	data->contents = contents;
+	if (!data->music.openFromMemory(contents->data(), contents->size()))
+	{
+		throw SceneDescriptionException("Couldn't load audio file '" + path + "'.");
+	}
+	return std::shared_ptr<sf::Music>(data, &data->music);
+}
+
+/// Reads the encoded contents of the sound file at the
+/// given path, or gets them from the cache.
+std::shared_ptr<const std::vector<char>> AssetCache::readEncodedSound(const std::string& path)
+{
+	return this->readCachedFile(AssetKey(AssetKind::EncodedSound, getCanonicalPath(path)));
+}
+
+/// Gets the number of bytes that the cache may use before
+/// unused assets are evicted.
+std::size_t AssetCache::getMemoryBudget() const
+{
+	return this->memoryBudget;
+}
+
+/// Sets the number of bytes that the cache may use before
+/// unused assets are evicted.
+void AssetCache::setMemoryBudget(std::size_t budget)
+{
+	this->memoryBudget = budget;
+	this->trim();
+}
+
+/// Gets the approximate number of bytes that the assets
+/// in this cache use.
+std::size_t AssetCache::getMemoryUsage() const
+{
+	return this->memoryUsage;
+}
+
+/// Gets the number of assets in this cache.
+std::size_t AssetCache::size() const
+{
+	return this->entries.size();
+}
+
+/// Evicts unused assets, in least-recently-used order,
+/// until the cache fits in its memory budget.
+void AssetCache::trim()
+{
+	if (this->memoryBudget > 0)
+		this->evict(this->memoryBudget);
+}
+
+/// Evicts all unused assets.
+void AssetCache::clear()
+{
+	this->evict(0);
+}
+
+/// Finds the asset with the given key, and marks it
+/// as recently used.
+std::shared_ptr<void> AssetCache::find(const AssetKey& key)
+{
+	auto pos = this->entries.find(key);
+	if (pos == this->entries.end())
+		return nullptr;
+
+	auto& entry = pos->second;
+	if (getFileStamp(key.second) != entry.stamp)
+	{
+		// The file has changed since it was loaded. Scenes
+		// that use the old asset will keep it alive.
+		this->erase(pos);
+		return nullptr;
+	}
+
+	this->useOrder.splice(this->useOrder.begin(), this->useOrder, entry.usePosition);
+	return entry.asset;
+}
+
+/// Adds the given asset to the cache, and then trims
+/// the cache.
+void AssetCache::insert(const AssetKey& key, const std::shared_ptr<void>& asset, std::size_t byteSize)
+{
+	auto pos = this->entries.find(key);
+	if (pos != this->entries.end())
+	{
+		// Replace the old asset. Scenes that still use
+		// it will keep it alive.
+		this->erase(pos);
+	}
+
+	this->useOrder.push_front(key);
+	this->entries[key] = CacheEntry { asset, byteSize, getFileStamp(key.second), this->useOrder.begin() };
+	this->memoryUsage += byteSize;
+	this->trim();
+}
+
+/// Reads the contents of the file with the given key,
+/// or gets them from the cache.
+std::shared_ptr<const std::vector<char>> AssetCache::readCachedFile(const AssetKey& key)
+{
+	auto contents = std::static_pointer_cast<const std::vector<char>>(this->find(key));
+	if (contents == nullptr)
+	{
+		contents = readFile(key.second);
+		if (contents == nullptr)
+		{
+			throw SceneDescriptionException("Couldn't load audio file '" + key.second + "'.");
+		}
+		this->insert(key, std::const_pointer_cast<std::vector<char>>(contents), contents->size());
+	}
+	return contents;
+}
+
+/// Reads the contents of the file at the given path.
+std::shared_ptr<const std::vector<char>> AssetCache::readFile(const std::string& path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+		return nullptr;
+
+	auto result = std::make_shared<std::vector<char>>(
+		std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	if (stream.bad())
+		return nullptr;
+
+	return result;
+}
+
+/// Removes the entry at the given position.
+void AssetCache::erase(std::map<AssetKey, CacheEntry>::iterator pos)
+{
+	this->memoryUsage -= pos->second.byteSize;
+	this->useOrder.erase(pos->second.usePosition);
+	this->entries.erase(pos);
+}
+
+/// Evicts unused assets, in least-recently-used order,
+/// until the cache uses no more than the given number
+/// of bytes.
+void AssetCache::evict(std::size_t maxUsage)
+{
+	auto pos = this->useOrder.end();
+	while (this->memoryUsage > maxUsage && pos != this->useOrder.begin())
+	{
+		--pos;
+		auto entryPos = this->entries.find(*pos);
+		// An asset is unused if the cache holds the only
+		// reference to it.
+		if (entryPos->second.asset.use_count() == 1)
+		{
+			// Step past the entry before erasing it.
+			++pos;
+			this->erase(entryPos);
+		}
+	}
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include "FileWatcher.h"
+
+namespace si
+{
+	namespace parser
+	{
+		/// Defines a process-wide cache of assets, which allows
+		/// scenes that use the same files to share a single copy
+		/// of them. Assets are keyed by their canonical path.
+		///
+		/// The cache is reference-counted: an asset is in use as
+		/// long as some scene holds a pointer to it. Assets that are
+		/// no longer in use stay in the cache, so re-parsing a scene
+		/// is cheap, until the cache's memory budget is exceeded.
+		/// Unused assets are then evicted in least-recently-used order.
+		/// Assets whose file has changed on disk since they were
+		/// loaded are never handed out again, so they are reloaded.
+		///
+		/// The asset cache is not thread-safe. It should only be
+		/// accessed by the thread that renders the game.
+		class AssetCache final
+		{
+		public:
+			AssetCache(const AssetCache&) = delete;
+
+			/// Gets the one and only asset cache.
+			static AssetCache& instance();
+
+			/// Gets the canonical version of the given path. If the
+			/// path cannot be resolved, then it is returned as-is.
+			static std::string getCanonicalPath(const std::string& path);
+
+			/// Finds the texture that was loaded from the given path.
+			/// Null is returned if the texture is not in the cache.
+			std::shared_ptr<sf::Texture> findTexture(const std::string& path);
+
+			/// Adds the given texture, which was loaded from the given
+			/// path, to the cache.
+			void insertTexture(const std::string& path, const std::shared_ptr<sf::Texture>& texture);
+
+			/// Finds the sound buffer that was loaded from the given path.
+			/// Null is returned if the sound buffer is not in the cache.
+			std::shared_ptr<sf::SoundBuffer> findSound(const std::string& path);
+
+			/// Adds the given sound buffer, which was loaded from the
+			/// given path, to the cache.
+			void insertSound(const std::string& path, const std::shared_ptr<sf::SoundBuffer>& sound);
+
+			/// Loads the font at the given path, or gets it from the
+			/// cache. A SceneDescriptionException is thrown if the font
+			/// could not be loaded.
+			std::shared_ptr<sf::Font> loadFont(const std::string& path);
+
+			/// Opens the music at the given path. Every call creates
+			/// a new music object, so scenes can play the same music
+			/// independently, but the music file's contents are read
+			/// only once. A SceneDescriptionException is thrown if the
+			/// music could not be opened.
+			std::shared_ptr<sf::Music> openMusic(const std::string& path);
+
+			/// Reads the encoded contents of the sound file at the
+			/// given path, or gets them from the cache. The contents
+			/// are not decoded. A SceneDescriptionException is thrown
+			/// if the file could not be read.
+			std::shared_ptr<const std::vector<char>> readEncodedSound(const std::string& path);
+
+			/// Gets the number of bytes that the cache may use before
+			/// unused assets are evicted. Zero means that there is
+			/// no budget.
+			std::size_t getMemoryBudget() const;
+
+			/// Sets the number of bytes that the cache may use before
+			/// unused assets are evicted. Zero means that there is
+			/// no budget.
+			void setMemoryBudget(std::size_t budget);
+
+			/// Gets the approximate number of bytes that the assets
+			/// in this cache use.
+			std::size_t getMemoryUsage() const;
+
+			/// Gets the number of assets in this cache.
+			std::size_t size() const;
+
+			/// Evicts unused assets, in least-recently-used order,
+			/// until the cache fits in its memory budget.
+			void trim();
+
+			/// Evicts all unused assets.
+			void clear();
+
+			/// The default number of bytes that the cache may
+			/// use before unused assets are evicted.
+			static const std::size_t DefaultMemoryBudget;
+
+		private:
+			AssetCache();
+
+			/// Identifies the kind of an asset.
+			enum class AssetKind
+			{
+				Texture,
+				Sound,
+				Font,
+				Music,
+				EncodedSound
+			};
+
+			typedef std::pair<AssetKind, std::string> AssetKey;
+
+			/// Describes an asset in the cache.
+			struct CacheEntry
+			{
+				/// The cached asset. For music and encoded
+				/// sounds, this is the file's contents.
+				std::shared_ptr<void> asset;
+				std::size_t byteSize;
+				/// The asset file's stamp when it was loaded.
+				FileStamp stamp;
+				/// The entry's position in the recently-used list.
+				std::list<AssetKey>::iterator usePosition;
+			};
+
+			/// Finds the asset with the given key, and marks it
+			/// as recently used. Null is returned if the asset is
+			/// not in the cache, or if its file has changed.
+			std::shared_ptr<void> find(const AssetKey& key);
+
+			/// Adds the given asset to the cache, and then trims
+			/// the cache.
+			void insert(const AssetKey& key, const std::shared_ptr<void>& asset, std::size_t byteSize);
+
+			/// Reads the contents of the file with the given key,
+			/// or gets them from the cache. A SceneDescriptionException
+			/// is thrown if the file could not be read.
+			std::shared_ptr<const std::vector<char>> readCachedFile(const AssetKey& key);
+
+			/// Reads the contents of the file at the given path.
+			/// Null is returned if the file could not be read.
+			static std::shared_ptr<const std::vector<char>> readFile(const std::string& path);
+
+			/// Removes the entry at the given position.
+			void erase(std::map<AssetKey, CacheEntry>::iterator pos);
+
+			/// Evicts unused assets, in least-recently-used order,
+			/// until the cache uses no more than the given number
+			/// of bytes.
+			void evict(std::size_t maxUsage);
+
+			std::map<AssetKey, CacheEntry> entries;
+			/// The cache's keys, from most to least recently used.
+			std::list<AssetKey> useOrder;
+			std::size_t memoryBudget;
+			std::size_t memoryUsage;
+		};
+	}
+}
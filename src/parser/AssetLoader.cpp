@@ -0,0 +1,328 @@
+#include "AssetLoader.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include "AssetCache.h"
+#include "SceneDescription.h"
+
+using namespace si;
+using namespace si::parser;
+
+namespace
+{
+	/// Decodes the sound file at the given path into a
+	/// buffer of samples. A boolean is returned that tells
+	/// if the sound file was decoded successfully.
+	bool decodeSoundFile(
+		const std::string& path, std::vector<sf::Int16>& samples,
+		unsigned int& channelCount, unsigned int& sampleRate)
+	{
+		sf::InputSoundFile file;
+		if (!file.openFromFile(path))
+			return false;
+
+		samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+		auto readCount = file.read(samples.data(), samples.size());
+		samples.resize(static_cast<std::size_t>(readCount));
+		channelCount = file.getChannelCount();
+		sampleRate = file.getSampleRate();
+		return true;
+	}
+}
+
+/// Creates an asset loader that uses the given number of
+/// worker threads.
+AssetLoader::AssetLoader(std::size_t threadCount)
+	: workers(), mutex(), jobQueued(), jobDecoded(),
+	  jobQueue(), decodedJobs(), isStopping(false),
+	  soundReadersRegistered(), pendingCriticalCount(0),
+	  loadedCount(0), totalCount(0), progressCallback()
+{
+	if (threadCount == 0)
+		threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+	for (std::size_t i = 0; i < threadCount; i++)
+	{
+		this->workers.emplace_back([this]() { this->runWorker(); });
+	}
+}
+
+/// Stops the worker threads.
+AssetLoader::~AssetLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->isStopping = true;
+	}
+	this->jobQueued.notify_all();
+
+	for (auto& item : this->workers)
+	{
+		item.join();
+	}
+}
+
+/// Starts loading the texture at the given path.
+std::shared_ptr<sf::Texture> AssetLoader::loadTexture(const std::string& path, bool isCritical)
+{
+	auto cached = AssetCache::instance().findTexture(path);
+	if (cached != nullptr)
+	{
+		this->addCachedAsset();
+		return cached;
+	}
+
+	auto asset = std::make_shared<PendingAsset>();
+	asset->path = path;
+	asset->isCritical = isCritical;
+	asset->texture = std::make_shared<sf::Texture>();
+	this->enqueue(asset);
+	return asset->texture;
+}
+
+/// Starts loading the sound at the given path.
+std::shared_ptr<sf::SoundBuffer> AssetLoader::loadSound(const std::string& path, bool isCritical)
+{
+	auto cached = AssetCache::instance().findSound(path);
+	if (cached != nullptr)
+	{
+		this->addCachedAsset();
+		return cached;
+	}
+
+	auto asset = std::make_shared<PendingAsset>();
+	asset->path = path;
+	asset->isCritical = isCritical;
+	asset->sound = std::make_shared<sf::SoundBuffer>();
+	this->enqueue(asset);
+	return asset->sound;
+}
+
+/// Sets the function that is notified whenever an
+/// asset has been loaded.
+void AssetLoader::setProgressCallback(const LoadProgressCallback& callback)
+{
+	this->progressCallback = callback;
+}
+
+/// Finishes all assets that have been decoded, without
+/// waiting for any other assets.
+bool AssetLoader::poll()
+{
+	this->finish(nullptr);
+	return this->loadedCount < this->totalCount;
+}
+
+/// Waits until all critical assets have been loaded.
+void AssetLoader::finishCritical()
+{
+	this->finish([this]() { return this->pendingCriticalCount == 0; });
+}
+
+/// Waits until all assets have been loaded.
+void AssetLoader::finishAll()
+{
+	this->finish([this]() { return this->loadedCount == this->totalCount; });
+}
+
+/// Gets the number of assets that have been loaded.
+std::size_t AssetLoader::getLoadedCount() const
+{
+	return this->loadedCount;
+}
+
+/// Gets the number of assets that have been requested.
+std::size_t AssetLoader::getTotalCount() const
+{
+	return this->totalCount;
+}
+
+/// Adds the given asset to the job queue.
+void AssetLoader::enqueue(const std::shared_ptr<PendingAsset>& asset)
+{
+	this->totalCount++;
+	if (asset->isCritical)
+		this->pendingCriticalCount++;
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		// Critical assets jump the queue.
+		if (asset->isCritical)
+			this->jobQueue.push_front(asset);
+		else
+			this->jobQueue.push_back(asset);
+	}
+	this->jobQueued.notify_one();
+}
+
+/// Counts an asset that was found in the asset cache
+/// as loaded.
+void AssetLoader::addCachedAsset()
+{
+	this->totalCount++;
+	this->loadedCount++;
+	if (this->progressCallback)
+		this->progressCallback(this->loadedCount, this->totalCount);
+}
+
+/// Takes jobs from the job queue and decodes them,
+/// until the asset loader is stopped.
+void AssetLoader::runWorker()
+{
+	while (true)
+	{
+		std::shared_ptr<PendingAsset> job;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->jobQueued.wait(lock, [this]()
+			{
+				return this->isStopping || !this->jobQueue.empty();
+			});
+
+			if (this->isStopping)
+				return;
+
+			job = this->jobQueue.front();
+			this->jobQueue.pop_front();
+		}
+
+		this->decode(*job);
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->decodedJobs.push_back(job);
+		}
+		this->jobDecoded.notify_all();
+	}
+}
+
+/// Decodes the given asset's file. This is called
+/// on a worker thread.
+void AssetLoader::decode(PendingAsset& asset)
+{
+	if (asset.texture != nullptr)
+	{
+		asset.isDecoded = asset.image.loadFromFile(asset.path);
+	}
+	else
+	{
+		bool isDone = false;
+		std::call_once(this->soundReadersRegistered, [&]()
+		{
+			asset.isDecoded = decodeSoundFile(
+				asset.path, asset.samples, asset.channelCount, asset.sampleRate);
+			isDone = true;
+		});
+
+		if (!isDone)
+		{
+			asset.isDecoded = decodeSoundFile(
+				asset.path, asset.samples, asset.channelCount, asset.sampleRate);
+		}
+	}
+}
+
+/// Hands the given decoded asset to SFML, adds it
+/// to the asset cache, and notifies the progress
+/// callback. A boolean is returned that tells if
+/// the asset was loaded successfully.
+bool AssetLoader::upload(PendingAsset& asset)
+{
+	bool isLoaded;
+	if (asset.texture != nullptr)
+	{
+		isLoaded = asset.isDecoded && asset.texture->loadFromImage(asset.image);
+		// The image is no longer needed.
+		asset.image = sf::Image();
+		if (isLoaded)
+			AssetCache::instance().insertTexture(asset.path, asset.texture);
+	}
+	else
+	{
+		isLoaded = asset.isDecoded && asset.sound->loadFromSamples(
+			asset.samples.data(), asset.samples.size(), asset.channelCount, asset.sampleRate);
+		// The sound buffer has its own copy of the samples.
+		std::vector<sf::Int16>().swap(asset.samples);
+		if (isLoaded)
+			AssetCache::instance().insertSound(asset.path, asset.sound);
+	}
+
+	// Assets that failed to load are done as well. Otherwise,
+	// waiting for them would never end.
+	this->loadedCount++;
+	if (asset.isCritical)
+		this->pendingCriticalCount--;
+
+	if (this->progressCallback)
+		this->progressCallback(this->loadedCount, this->totalCount);
+
+	return isLoaded;
+}
+
+/// Finishes decoded assets until the given predicate
+/// is satisfied.
+void AssetLoader::finish(const std::function<bool()>& isDone)
+{
+	while (true)
+	{
+		std::vector<std::shared_ptr<PendingAsset>> ready;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			if (isDone)
+			{
+				if (isDone())
+					return;
+
+				// There are still assets that have to be loaded, so
+				// wait for one of them to be decoded.
+				this->jobDecoded.wait(lock, [this]() { return !this->decodedJobs.empty(); });
+			}
+			ready.swap(this->decodedJobs);
+		}
+
+		// Upload the entire batch, even if one of its assets
+		// fails to load. The other assets would be lost otherwise.
+		std::string error;
+		for (const auto& item : ready)
+		{
+			if (this->upload(*item))
+				continue;
+
+			std::string message = std::string(item->texture != nullptr
+				? "Couldn't load texture file '"
+				: "Couldn't load audio file '") + item->path + "'.";
+			if (isDone)
+			{
+				// The caller is waiting for this asset, so it can't
+				// do without it. Report the first error once the
+				// batch is done.
+				if (error.empty())
+					error = message;
+			}
+			else
+			{
+				// The asset was streamed in while the scene is running.
+				// Its empty texture or sound buffer is left in place,
+				// which renders or plays as nothing.
+				std::cout << message << " It will be left empty." << std::endl;
+			}
+		}
+
+		if (!error.empty())
+			throw SceneDescriptionException(error);
+
+		if (!isDone)
+			return;
+	}
+}
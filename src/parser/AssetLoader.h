@@ -0,0 +1,168 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+
+namespace si
+{
+	namespace parser
+	{
+		/// A type for functions that are notified of loading progress.
+		/// The number of assets that have been loaded, as well as the
+		/// total number of assets that have been requested, are given.
+		typedef std::function<void(std::size_t loadedCount, std::size_t totalCount)> LoadProgressCallback;
+
+		/// Defines an asset loader, which decodes image and
+		/// sound files on a pool of worker threads.
+		///
+		/// Decoded assets are handed to SFML on the thread that
+		/// owns the asset loader, which is assumed to be the
+		/// thread that renders the game: textures must be uploaded
+		/// on that thread. Asset objects are created right away,
+		/// but remain empty until they have been finished by `poll`,
+		/// `finishCritical` or `finishAll`.
+		class AssetLoader final
+		{
+		public:
+			/// Creates an asset loader that uses the given number of
+			/// worker threads. If the thread count is zero, then
+			/// a thread count is picked based on the hardware.
+			AssetLoader(std::size_t threadCount = 0);
+
+			AssetLoader(const AssetLoader&) = delete;
+
+			/// Stops the worker threads. Assets that have not
+			/// been finished yet will remain empty.
+			~AssetLoader();
+
+			/// Starts loading the texture at the given path. If the
+			/// texture is in the asset cache, then the cached texture is
+			/// returned. Otherwise, an empty texture is returned, which
+			/// will be filled in once the image file has been decoded.
+			/// Critical assets are decoded before non-critical assets.
+			std::shared_ptr<sf::Texture> loadTexture(const std::string& path, bool isCritical = true);
+
+			/// Starts loading the sound at the given path. If the sound
+			/// is in the asset cache, then the cached sound buffer is
+			/// returned. Otherwise, an empty sound buffer is returned,
+			/// which will be filled in once the sound file has been
+			/// decoded. Critical assets are decoded before non-critical
+			/// assets.
+			std::shared_ptr<sf::SoundBuffer> loadSound(const std::string& path, bool isCritical = true);
+
+			/// Sets the function that is notified whenever an
+			/// asset has been loaded.
+			void setProgressCallback(const LoadProgressCallback& callback);
+
+			/// Finishes all assets that have been decoded, without
+			/// waiting for any other assets. A boolean is returned
+			/// that tells if there are still assets left to load.
+			/// Assets that could not be loaded are reported on the
+			/// standard output, and left empty.
+			bool poll();
+
+			/// Waits until all critical assets have been loaded.
+			/// A SceneDescriptionException is thrown if an asset
+			/// could not be loaded.
+			void finishCritical();
+
+			/// Waits until all assets have been loaded.
+			/// A SceneDescriptionException is thrown if an asset
+			/// could not be loaded.
+			void finishAll();
+
+			/// Gets the number of assets that have been loaded.
+			std::size_t getLoadedCount() const;
+
+			/// Gets the number of assets that have been requested.
+			std::size_t getTotalCount() const;
+
+		private:
+			/// Describes an asset that has been requested, but
+			/// which has not been loaded yet.
+			struct PendingAsset
+			{
+				std::string path;
+				bool isCritical;
+
+				/// The asset that is filled in once the file has been
+				/// decoded. Exactly one of these is not null.
+				std::shared_ptr<sf::Texture> texture;
+				std::shared_ptr<sf::SoundBuffer> sound;
+
+				/// The decoded file's contents.
+				sf::Image image;
+				std::vector<sf::Int16> samples;
+				unsigned int channelCount;
+				unsigned int sampleRate;
+
+				/// Tells if the file was decoded successfully.
+				bool isDecoded;
+			};
+
+			/// Adds the given asset to the job queue.
+			void enqueue(const std::shared_ptr<PendingAsset>& asset);
+
+			/// Counts an asset that was found in the asset cache
+			/// as loaded.
+			void addCachedAsset();
+
+			/// Takes jobs from the job queue and decodes them,
+			/// until the asset loader is stopped.
+			void runWorker();
+
+			/// Decodes the given asset's file. This is called
+			/// on a worker thread.
+			void decode(PendingAsset& asset);
+
+			/// Hands the given decoded asset to SFML, adds it
+			/// to the asset cache, and notifies the progress
+			/// callback. A boolean is returned that tells if
+			/// the asset was loaded successfully.
+			bool upload(PendingAsset& asset);
+
+			/// Finishes decoded assets until the given predicate
+			/// is satisfied. If the predicate is null, then only
+			/// the assets that have already been decoded are
+			/// finished. If an asset fails to load, then the rest
+			/// of its batch is still finished. Failures are only
+			/// thrown as exceptions if a predicate is given, i.e.,
+			/// if the caller waits for the assets.
+			void finish(const std::function<bool()>& isDone);
+
+			std::vector<std::thread> workers;
+
+			/// Guards the job queue, the decoded list and the
+			/// stop flag.
+			std::mutex mutex;
+			std::condition_variable jobQueued;
+			std::condition_variable jobDecoded;
+			std::deque<std::shared_ptr<PendingAsset>> jobQueue;
+			std::vector<std::shared_ptr<PendingAsset>> decodedJobs;
+			bool isStopping;
+
+			/// SFML registers its sound file readers the first
+			/// time a sound file is opened, which is not
+			/// thread-safe. The first sound file is decoded under
+			/// this flag, so that other sound files are only
+			/// decoded once registration has completed.
+			std::once_flag soundReadersRegistered;
+
+			/// These counters are only accessed by the thread that
+			/// owns the asset loader.
+			std::size_t pendingCriticalCount;
+			std::size_t loadedCount;
+			std::size_t totalCount;
+			LoadProgressCallback progressCallback;
+		};
+	}
+}
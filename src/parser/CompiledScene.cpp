@@ -0,0 +1,290 @@
+#include "CompiledScene.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "tinyxml2/tinyxml2.h"
+#include "SceneDescription.h"
+
+using namespace si;
+using namespace si::parser;
+
+namespace
+{
+	const char CompiledSceneMagic[4] = { 'S', 'I', 'B', 'S' };
+	const std::uint32_t CompiledSceneVersion = 1;
+
+	/// Writes compiled scenes. Strings are interned as
+	/// they are encountered.
+	class CompiledSceneWriter final
+	{
+	public:
+		CompiledSceneWriter()
+			: stringIndices(), stringOffsets(), stringData(),
+			  elementCount(0), elementData()
+		{ }
+
+		/// Appends the given element, and all of its
+		/// descendants, to the element list.
+		void writeElement(const tinyxml2::XMLElement* node)
+		{
+			this->elementCount++;
+			this->writeUInt32(this->elementData, this->intern(node->Name()));
+
+			std::uint32_t attributeCount = 0;
+			for (auto attr = node->FirstAttribute(); attr != nullptr; attr = attr->Next())
+				attributeCount++;
+
+			std::uint32_t childCount = 0;
+			for (auto child = node->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+				childCount++;
+
+			this->writeUInt32(this->elementData, attributeCount);
+			this->writeUInt32(this->elementData, childCount);
+			for (auto attr = node->FirstAttribute(); attr != nullptr; attr = attr->Next())
+			{
+				this->writeUInt32(this->elementData, this->intern(attr->Name()));
+				this->writeUInt32(this->elementData, this->intern(attr->Value()));
+			}
+
+			for (auto child = node->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+			{
+				this->writeElement(child);
+			}
+		}
+
+		/// Gets the compiled scene's contents.
+		std::vector<char> finish() const
+		{
+			std::vector<char> result(std::begin(CompiledSceneMagic), std::end(CompiledSceneMagic));
+			this->writeUInt32(result, CompiledSceneVersion);
+			this->writeUInt32(result, static_cast<std::uint32_t>(this->stringOffsets.size()));
+			this->writeUInt32(result, static_cast<std::uint32_t>(this->stringData.size()));
+			for (auto item : this->stringOffsets)
+			{
+				this->writeUInt32(result, item);
+			}
+			result.insert(result.end(), this->stringData.begin(), this->stringData.end());
+			this->writeUInt32(result, this->elementCount);
+			result.insert(result.end(), this->elementData.begin(), this->elementData.end());
+			return result;
+		}
+
+	private:
+		/// Gets the index of the given string in the
+		/// string table.
+		std::uint32_t intern(const char* value)
+		{
+			auto result = this->stringIndices.insert(std::make_pair(
+				std::string(value), static_cast<std::uint32_t>(this->stringOffsets.size())));
+			if (result.second)
+			{
+				// This is a new string.
+				this->stringOffsets.push_back(static_cast<std::uint32_t>(this->stringData.size()));
+				this->stringData.insert(this->stringData.end(), value, value + std::strlen(value) + 1);
+			}
+			return result.first->second;
+		}
+
+		/// Appends the given integer to the given buffer.
+		static void writeUInt32(std::vector<char>& target, std::uint32_t value)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				target.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+			}
+		}
+
+		std::unordered_map<std::string, std::uint32_t> stringIndices;
+		std::vector<std::uint32_t> stringOffsets;
+		std::vector<char> stringData;
+		std::uint32_t elementCount;
+		std::vector<char> elementData;
+	};
+
+	/// Reads compiled scenes from a buffer. Strings are read
+	/// straight from the buffer's string table, without any
+	/// lexing or unescaping. The document copies them into
+	/// its own memory pools.
+	class CompiledSceneReader final
+	{
+	public:
+		CompiledSceneReader(const std::vector<char>& data, const std::string& path)
+			: data(data), path(path), offset(0), strings()
+		{ }
+
+		/// Reads the compiled scene into the given document.
+		void read(tinyxml2::XMLDocument& doc)
+		{
+			if (this->data.size() < sizeof(CompiledSceneMagic)
+				|| std::memcmp(this->data.data(), CompiledSceneMagic, sizeof(CompiledSceneMagic)) != 0)
+			{
+				this->fail("it is not a compiled scene");
+			}
+			this->offset = sizeof(CompiledSceneMagic);
+			if (this->readUInt32() != CompiledSceneVersion)
+				this->fail("it was compiled for a different version");
+
+			this->readStringTable();
+
+			auto elementCount = this->readUInt32();
+			if (elementCount == 0)
+				this->fail("it does not have a root element");
+
+			// Elements are read iteratively, so malformed files
+			// can't exhaust the stack. Every entry on the stack is
+			// an element that still has children left to read.
+			std::vector<std::pair<tinyxml2::XMLNode*, std::uint32_t>> parents;
+			parents.emplace_back(&doc, 1);
+			for (std::uint32_t i = 0; i < elementCount; i++)
+			{
+				if (parents.empty())
+					this->fail("it has more elements than its element tree describes");
+
+				// Link new elements right away, so the document
+				// owns them even if the rest of the file is malformed.
+				auto element = doc.NewElement(this->readString());
+				parents.back().first->InsertEndChild(element);
+				if (--parents.back().second == 0)
+					parents.pop_back();
+
+				auto attributeCount = this->readUInt32();
+				auto childCount = this->readUInt32();
+				for (std::uint32_t j = 0; j < attributeCount; j++)
+				{
+					auto name = this->readString();
+					element->SetAttribute(name, this->readString());
+				}
+
+				if (childCount > 0)
+					parents.emplace_back(element, childCount);
+			}
+
+			if (!parents.empty() || this->offset != this->data.size())
+				this->fail("its element tree is inconsistent");
+		}
+
+	private:
+		/// Reads the string table.
+		void readStringTable()
+		{
+			auto stringCount = this->readUInt32();
+			auto stringDataSize = this->readUInt32();
+			if (stringCount > (this->data.size() - this->offset) / 4)
+				this->fail("it ends unexpectedly");
+
+			std::vector<std::uint32_t> offsets;
+			offsets.reserve(stringCount);
+			for (std::uint32_t i = 0; i < stringCount; i++)
+			{
+				offsets.push_back(this->readUInt32());
+			}
+
+			if (stringDataSize > this->data.size() - this->offset
+				|| (stringDataSize > 0 && this->data[this->offset + stringDataSize - 1] != '\0'))
+			{
+				this->fail("its string table is malformed");
+			}
+
+			// Every string ends at or before the string data's
+			// final null terminator.
+			const char* stringData = this->data.data() + this->offset;
+			for (auto item : offsets)
+			{
+				if (item >= stringDataSize)
+					this->fail("its string table is malformed");
+				this->strings.push_back(stringData + item);
+			}
+			this->offset += stringDataSize;
+		}
+
+		/// Reads an integer.
+		std::uint32_t readUInt32()
+		{
+			if (this->data.size() - this->offset < 4)
+				this->fail("it ends unexpectedly");
+
+			std::uint32_t result = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				result |= static_cast<std::uint32_t>(
+					static_cast<unsigned char>(this->data[this->offset + i])) << (8 * i);
+			}
+			this->offset += 4;
+			return result;
+		}
+
+		/// Reads a reference to the string table.
+		const char* readString()
+		{
+			auto index = this->readUInt32();
+			if (index >= this->strings.size())
+				this->fail("it refers to a string that does not exist");
+			return this->strings[index];
+		}
+
+		/// Throws an exception that explains why the compiled
+		/// scene could not be read.
+		[[noreturn]] void fail(const std::string& reason) const
+		{
+			throw SceneDescriptionException(
+				"Couldn't load compiled scene '" + this->path + "', because " + reason + ".");
+		}
+
+		const std::vector<char>& data;
+		const std::string& path;
+		std::size_t offset;
+		std::vector<const char*> strings;
+	};
+}
+
+/// Tests if the file at the given path is a compiled scene.
+bool si::parser::isCompiledScene(const std::string& path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	char magic[sizeof(CompiledSceneMagic)];
+	return stream.read(magic, sizeof(magic))
+		&& std::memcmp(magic, CompiledSceneMagic, sizeof(magic)) == 0;
+}
+
+/// Writes the given scene description document to the given
+/// path as a compiled scene.
+void si::parser::writeCompiledScene(const tinyxml2::XMLDocument& doc, const std::string& path)
+{
+	auto root = doc.RootElement();
+	if (root == nullptr)
+		throw SceneDescriptionException("Couldn't compile scene, because it does not have a root element.");
+
+	CompiledSceneWriter writer;
+	writer.writeElement(root);
+	auto contents = writer.finish();
+
+	std::ofstream stream(path, std::ios::binary);
+	if (!stream.write(contents.data(), contents.size()))
+		throw SceneDescriptionException("Couldn't write compiled scene '" + path + "'.");
+}
+
+/// Reads the compiled scene at the given path into the given
+/// document.
+void si::parser::readCompiledScene(const std::string& path, tinyxml2::XMLDocument& doc)
+{
+	// Read the entire file at once. The document copies every
+	// string it needs, so the file's contents can be discarded
+	// once the document has been built.
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+		throw SceneDescriptionException("Couldn't open compiled scene '" + path + "'.");
+
+	std::vector<char> contents(
+		(std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	doc.DeleteChildren();
+	CompiledSceneReader reader(contents, path);
+	reader.read(doc);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include "tinyxml2/tinyxml2.h"
+
+namespace si
+{
+	namespace parser
+	{
+		/// Compiled scenes are scene description documents that have
+		/// been serialized to a compact binary format. Loading a
+		/// compiled scene skips XML lexing altogether: all element
+		/// and attribute names, as well as attribute values, are
+		/// stored in a string table, which is referred to by a
+		/// flat, pre-order list of elements. Only lexing is
+		/// skipped: a compiled scene is still loaded into a
+		/// tinyxml2 document, whose attributes are parsed the
+		/// same way as those of an XML scene description.
+		///
+		/// All integers are 32-bit, unsigned and little-endian.
+		/// The file layout is:
+		///
+		///     "SIBS"  version
+		///     stringCount  stringDataSize
+		///     stringOffsets[stringCount]
+		///     stringData[stringDataSize]    (null-terminated strings)
+		///     elementCount
+		///     elements[elementCount]
+		///
+		/// where every element is:
+		///
+		///     name  attributeCount  childCount
+		///     (attributeName  attributeValue)[attributeCount]
+		///
+		/// followed by its children.
+
+		/// Tests if the file at the given path is a compiled scene.
+		bool isCompiledScene(const std::string& path);
+
+		/// Writes the given scene description document to the given
+		/// path as a compiled scene. A SceneDescriptionException is
+		/// thrown if something goes wrong.
+		void writeCompiledScene(const tinyxml2::XMLDocument& doc, const std::string& path);
+
+		/// Reads the compiled scene at the given path into the given
+		/// document. A SceneDescriptionException is thrown if the
+		/// compiled scene is malformed.
+		void readCompiledScene(const std::string& path, tinyxml2::XMLDocument& doc);
+	}
+}
@@ -0,0 +1,173 @@
+#include "FileWatcher.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include "AssetCache.h"
+
+using namespace si;
+using namespace si::parser;
+
+namespace
+{
+	/// The interval at which watched files are polled, if
+	/// they can't be watched by the operating system.
+	const std::chrono::milliseconds StampPollInterval(250);
+}
+
+bool FileStamp::operator==(const FileStamp& other) const
+{
+	return this->exists == other.exists
+		&& this->modificationTime == other.modificationTime
+		&& this->size == other.size;
+}
+
+bool FileStamp::operator!=(const FileStamp& other) const
+{
+	return !(*this == other);
+}
+
+/// Gets the stamp of the file at the given path.
+FileStamp si::parser::getFileStamp(const std::string& path)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return FileStamp { 0, 0, false };
+
+#ifdef __linux__
+	// Use nanosecond precision where we can get it:
+	// whole seconds are too coarse for quick edits.
+	long long modificationTime =
+		static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+	long long modificationTime = static_cast<long long>(info.st_mtime);
+#endif
+	return FileStamp { modificationTime, static_cast<long long>(info.st_size), true };
+}
+
+/// Creates a file watcher that does not watch any files.
+FileWatcher::FileWatcher()
+	: files(), lastPollTime(std::chrono::steady_clock::now())
+#ifdef __linux__
+	, inotifyFd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), directories()
+#endif
+{ }
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if (this->inotifyFd >= 0)
+		close(this->inotifyFd);
+#endif
+}
+
+/// Starts watching the file at the given path.
+void FileWatcher::watch(const std::string& path)
+{
+	auto canonicalPath = AssetCache::getCanonicalPath(path);
+	this->files[canonicalPath] = getFileStamp(canonicalPath);
+
+#ifdef __linux__
+	if (this->inotifyFd < 0)
+		return;
+
+	// Files that don't exist can't be resolved to an absolute
+	// path, and can't be watched.
+	auto separator = canonicalPath.find_last_of('/');
+	if (separator == std::string::npos)
+		return;
+
+	auto directory = canonicalPath.substr(0, separator + 1);
+
+	// Adding a watch for a directory that is already watched
+	// returns the existing watch descriptor.
+	int descriptor = inotify_add_watch(
+		this->inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+	if (descriptor >= 0)
+		this->directories[descriptor] = directory;
+#endif
+}
+
+/// Stops watching all files.
+void FileWatcher::clear()
+{
+	this->files.clear();
+#ifdef __linux__
+	if (this->inotifyFd < 0)
+		return;
+
+	for (const auto& item : this->directories)
+	{
+		inotify_rm_watch(this->inotifyFd, item.first);
+	}
+	this->directories.clear();
+#endif
+}
+
+/// Tests if any of the watched files have changed since
+/// this method was last called.
+bool FileWatcher::poll()
+{
+#ifdef __linux__
+	if (this->inotifyFd >= 0)
+		return this->pollEvents();
+#endif
+	return this->pollStamps();
+}
+
+/// Polls the watched files' stamps.
+bool FileWatcher::pollStamps()
+{
+	auto now = std::chrono::steady_clock::now();
+	if (now - this->lastPollTime < StampPollInterval)
+		return false;
+
+	this->lastPollTime = now;
+	bool hasChanged = false;
+	for (auto& item : this->files)
+	{
+		auto stamp = getFileStamp(item.first);
+		if (stamp != item.second)
+		{
+			item.second = stamp;
+			hasChanged = true;
+		}
+	}
+	return hasChanged;
+}
+
+#ifdef __linux__
+/// Reads pending inotify events.
+bool FileWatcher::pollEvents()
+{
+	bool hasChanged = false;
+	alignas(inotify_event) char buffer[4096];
+	while (true)
+	{
+		auto length = read(this->inotifyFd, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+
+		for (char* ptr = buffer; ptr < buffer + length; )
+		{
+			auto event = reinterpret_cast<const inotify_event*>(ptr);
+			auto directory = this->directories.find(event->wd);
+			if (event->len > 0 && directory != this->directories.end()
+				&& this->files.find(directory->second + event->name) != this->files.end())
+			{
+				hasChanged = true;
+			}
+			ptr += sizeof(inotify_event) + event->len;
+		}
+	}
+	return hasChanged;
+}
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+namespace si
+{
+	namespace parser
+	{
+		/// Describes the state of a file on disk. Two stamps
+		/// that differ indicate that the file has changed.
+		struct FileStamp
+		{
+			/// The file's last modification time.
+			long long modificationTime;
+			/// The file's size, in bytes.
+			long long size;
+			/// Tells if the file exists.
+			bool exists;
+
+			bool operator==(const FileStamp& other) const;
+			bool operator!=(const FileStamp& other) const;
+		};
+
+		/// Gets the stamp of the file at the given path.
+		FileStamp getFileStamp(const std::string& path);
+
+		/// Defines a file watcher, which tells when files change.
+		/// On Linux, this is driven by inotify. Elsewhere, watched
+		/// files are polled a few times per second.
+		class FileWatcher final
+		{
+		public:
+			/// Creates a file watcher that does not watch any files.
+			FileWatcher();
+
+			FileWatcher(const FileWatcher&) = delete;
+
+			~FileWatcher();
+
+			/// Starts watching the file at the given path.
+			void watch(const std::string& path);
+
+			/// Stops watching all files.
+			void clear();
+
+			/// Tests if any of the watched files have changed since
+			/// this method was last called. This does not block.
+			bool poll();
+
+		private:
+			/// Polls the watched files' stamps.
+			bool pollStamps();
+
+			/// The watched files, by canonical path, along with
+			/// their last known stamps.
+			std::unordered_map<std::string, FileStamp> files;
+
+			/// The last time that the watched files' stamps
+			/// were polled.
+			std::chrono::steady_clock::time_point lastPollTime;
+
+#ifdef __linux__
+			/// Reads pending inotify events.
+			bool pollEvents();
+
+			/// The inotify instance, or -1 if inotify is not
+			/// available.
+			int inotifyFd;
+
+			/// Maps inotify watch descriptors to the directories
+			/// they watch. inotify watches directories rather than
+			/// files, because editors tend to replace files when
+			/// saving them.
+			std::unordered_map<int, std::string> directories;
+#endif
+		};
+	}
+}
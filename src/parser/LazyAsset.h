@@ -0,0 +1,67 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace si
+{
+	namespace parser
+	{
+		/// Defines a handle to an asset that is only created
+		/// when it is first requested. Copies of a lazy asset
+		/// share a single value, which is created at most once.
+		///
+		/// Lazy assets are resolved while a scene is being read,
+		/// on the thread that reads it. They are not thread-safe.
+		template<typename T>
+		class LazyAsset final
+		{
+		public:
+			/// A type for functions that create assets. The given
+			/// flag tells if the asset is needed before the scene
+			/// can start.
+			typedef std::function<T(bool isCritical)> Creator;
+
+			/// Creates a lazy asset that is created by the
+			/// given function.
+			LazyAsset(const Creator& create)
+				: state(std::make_shared<State>())
+			{
+				this->state->create = create;
+				this->state->isCreated = false;
+			}
+
+			/// Gets this lazy asset's value. The value is created
+			/// if this has not been done yet. The given flag tells
+			/// if the asset is needed before the scene can start.
+			const T& get(bool isCritical) const
+			{
+				if (!this->state->isCreated)
+				{
+					this->state->value = this->state->create(isCritical);
+					this->state->isCreated = true;
+					// Release whatever the creation function holds
+					// on to: it will never be called again.
+					this->state->create = nullptr;
+				}
+				return this->state->value;
+			}
+
+			/// Tests if this lazy asset's value has been created.
+			bool isCreated() const
+			{
+				return this->state->isCreated;
+			}
+
+		private:
+			struct State
+			{
+				Creator create;
+				T value;
+				bool isCreated;
+			};
+
+			std::shared_ptr<State> state;
+		};
+	}
+}
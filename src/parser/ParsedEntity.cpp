@@ -22,8 +22,10 @@ void si::parser::addToScene(
 }
 
 /// Creates an event that adds the given vector
-/// of controllers to the scene.
+/// of controllers to the scene, and attaches them
+/// to the given entity.
 si::timeline::ITimelineEvent_ptr si::parser::createAddControllersEvent(
+	const si::model::Entity_ptr& owner,
 	const std::vector<UnboundController>& items)
 {
 	return std::make_shared<si::timeline::InstantaneousEvent>(
@@ -31,14 +33,16 @@ si::timeline::ITimelineEvent_ptr si::parser::createAddControllersEvent(
 		{
 			for (const auto& item : items)
 			{
-				target.addController(item(target));
+				target.addController(item(target), owner);
 			}
 		});
 }
 
 /// Creates an event that adds the given vector
-/// of controllers to the scene.
+/// of controllers to the scene, and attaches them
+/// to the given entity.
 si::timeline::ITimelineEvent_ptr si::parser::createAddControllersEvent(
+	const si::model::Entity_ptr& owner,
 	const std::vector<si::controller::IController_ptr>& items)
 {
 	return std::make_shared<si::timeline::InstantaneousEvent>(
@@ -46,11 +50,24 @@ si::timeline::ITimelineEvent_ptr si::parser::createAddControllersEvent(
 		{
 			for (const auto& item : items)
 			{
-				target.addController(item);
+				target.addController(item, owner);
 			}
 		});
 }
 
+/// Creates an event that constrains the given entity
+/// to the given bounds (in relative coordinates).
+si::timeline::ITimelineEvent_ptr si::parser::createAddBoundsConstraintEvent(
+	const si::model::Entity_ptr& entity,
+	si::DoubleRect bounds)
+{
+	return std::make_shared<si::timeline::InstantaneousEvent>(
+		[=](Scene& target) -> void
+		{
+			target.addBoundsConstraint(entity, bounds);
+		});
+}
+
 /// Creates a bullet that is fired from the given source.
 /// Momentum is transferred from the source entity to
 /// the projectile, but the bullet is not added to the
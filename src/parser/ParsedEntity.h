@@ -114,17 +114,28 @@ namespace si
 		}
 
 		/// Creates an event that adds the given vector
-		/// of controllers to the scene.
+		/// of controllers to the scene, and attaches them
+		/// to the given entity.
 		si::timeline::ITimelineEvent_ptr createAddControllersEvent(
+			const si::model::Entity_ptr& owner,
 			const std::vector<UnboundController>& items);
 
 		/// Creates an event that adds the given vector
-		/// of controllers to the scene.
+		/// of controllers to the scene, and attaches them
+		/// to the given entity.
 		si::timeline::ITimelineEvent_ptr createAddControllersEvent(
+			const si::model::Entity_ptr& owner,
 			const std::vector<si::controller::IController_ptr>& items);
 
+		/// Creates an event that constrains the given entity
+		/// to the given bounds (in relative coordinates).
+		si::timeline::ITimelineEvent_ptr createAddBoundsConstraintEvent(
+			const si::model::Entity_ptr& entity,
+			si::DoubleRect bounds);
+
 		/// Adds the given vector of controllers to a parsed entity's
-		/// creation event.
+		/// creation event. The controllers are attached to the
+		/// parsed entity's model.
 		template<typename T>
 		ParsedEntity<T> addControllers(
 			const ParsedEntity<T>& target,
@@ -134,7 +145,22 @@ namespace si
 				target.model,
 				si::timeline::concurrent({
 					target.creationEvent,
-					createAddControllersEvent(items)
+					createAddControllersEvent(target.model, items)
+				}));
+		}
+
+		/// Constrains a parsed entity to the given bounds (in relative
+		/// coordinates) once it has been created.
+		template<typename T>
+		ParsedEntity<T> addBoundsConstraint(
+			const ParsedEntity<T>& target,
+			si::DoubleRect bounds)
+		{
+			return ParsedEntity<T>(
+				target.model,
+				si::timeline::concurrent({
+					target.creationEvent,
+					createAddBoundsConstraintEvent(target.model, bounds)
 				}));
 		}
 
@@ -1,16 +1,22 @@
 #include "SceneDescription.h"
 
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <fstream>
-#include <map>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
 #include "tinyxml2/tinyxml2.h"
 #include "Common.h"
+#include "model/CollisionLayers.h"
 #include "model/Entity.h"
 #include "model/PhysicsEntity.h"
 #include "model/ShipEntity.h"
@@ -19,7 +25,6 @@
 #include "controller/ActionController.h"
 #include "controller/IntervalActionController.h"
 #include "controller/PlayerController.h"
-#include "controller/OutOfBoundsController.h"
 #include "controller/ShipCollisionController.h"
 #include "controller/ProjectileCollisionController.h"
 #include "controller/ObstacleCollisionController.h"
@@ -45,8 +50,14 @@
 #include "timeline/BackgroundEvent.h"
 #include "timeline/SoundEvent.h"
 #include "timeline/MusicEvent.h"
+#include "KeyBindings.h"
 #include "Scene.h"
 #include "ParsedEntity.h"
+#include "AssetCache.h"
+#include "CompiledScene.h"
+#include "FileWatcher.h"
+#include "LazyAsset.h"
+#include "XMLElementScanner.h"
 
 using namespace si;
 using namespace si::parser;
@@ -122,13 +133,30 @@ SceneDescriptionException::SceneDescriptionException(const std::string& message)
 	: std::runtime_error(message)
 { }
 
+// Scene description documents that are larger than this
+// many bytes are streamed, rather than parsed all at once.
+const long long StreamingThreshold = 1 << 20;
+
 /// Creates a new scene description from the
-/// XML document at the given path.
+/// XML document or compiled scene at the given path.
 SceneDescription::SceneDescription(const std::string& path)
-	: path(path)
+	: doc(), path(path), isStreaming(false), text(), sections(), duplicateSections()
 {
-	this->doc.LoadFile(this->path.c_str());
-	this->throwError();
+	auto stamp = getFileStamp(this->path);
+	if (isCompiledScene(this->path))
+	{
+		readCompiledScene(this->path, this->doc);
+	}
+	else if (stamp.exists && stamp.size > StreamingThreshold)
+	{
+		this->isStreaming = true;
+		this->readSections();
+	}
+	else
+	{
+		this->doc.LoadFile(this->path.c_str());
+		this->throwError();
+	}
 }
 
 /// Gets the path of the XML document
@@ -138,48 +166,92 @@ std::string SceneDescription::getPath() const
 	return this->path;
 }
 
-// Constants that define XML node names.
-const char* const AnimatedSpriteNodeName = "AnimatedSprite";
-const char* const PlayerNodeName = "Player";
-const char* const SpriteNodeName = "Sprite";
-const char* const BoxNodeName = "Box";
-const char* const GroupNodeName = "Group";
-const char* const ProjectileNodeName = "Projectile";
-const char* const ShipNodeName = "Ship";
-const char* const ObstacleNodeName = "Obstacle";
-const char* const AssetsTableNodeName = "Assets";
-const char* const TextureTableNodeName = "Textures";
-const char* const SoundsTableNodeName = "Sounds";
-const char* const MusicTableNodeName = "Music";
-const char* const FontsTableNodeName = "Fonts";
-const char* const DecorTableNodeName = "Decor";
-const char* const BackgroundTableNodeName = "Background";
-const char* const TimelineNodeName = "Timeline";
-const char* const SpawnNodeName = "Spawn";
-const char* const DeadlineNodeName = "Deadline";
-const char* const PermanentNodeName = "Permanent";
-const char* const ConcurrentNodeName = "Concurrent";
-const char* const ControllersNodeName = "Controllers";
-const char* const ShowNodeName = "Show";
-const char* const WaveNodeName = "Wave";
-const char* const ConditionNodeName = "Condition";
-const char* const ThenNodeName = "Then";
-const char* const ElseNodeName = "Else";
-const char* const RibbonParticleNodeName = "RibbonParticle";
-const char* const ParticleEmitterNodeName = "ParticleEmitter";
-const char* const FramecounterNodeName = "Framecounter";
-const char* const TextNodeName = "Text";
-const char* const GravityNodeName = "Gravity";
-const char* const LoopNodeName = "Loop";
-const char* const BackgroundNodeName = "Background";
-const char* const MainNodeName = "Main";
-const char* const ExtraNodeName = "Extra";
-const char* const SoundNodeName = "Sound";
-const char* const MusicNodeName = "Music";
-const char* const SetFlagNodeName = "SetFlag";
-const char* const OnLeaveNodeName = "OnLeave";
-const char* const OnEnterNodeName = "OnEnter";
-const char* const WaitNodeName = "Wait";
+/// Writes this scene description to the given
+/// path as a compiled scene.
+void SceneDescription::compile(const std::string& outputPath) const
+{
+	if (this->isStreaming)
+	{
+		// Compiled scenes are written from a complete
+		// document.
+		tinyxml2::XMLDocument fullDoc;
+		fullDoc.Parse(this->text.data(), this->text.size());
+		if (fullDoc.Error())
+		{
+			throw XMLParseException(fullDoc);
+		}
+		writeCompiledScene(fullDoc, outputPath);
+	}
+	else
+	{
+		writeCompiledScene(this->doc, outputPath);
+	}
+}
+
+/// Computes the 32-bit FNV-1a hash of the given string. This
+/// is evaluated at compile time for constant strings, which
+/// allows node names to be dispatched on with a switch.
+/// A switch on names that collide does not compile, so the
+/// hash is a perfect hash for the names in any switch.
+constexpr std::uint32_t hashName(const char* name, std::uint32_t hash = 2166136261u)
+{
+	return *name == '\0'
+		? hash
+		: hashName(name + 1, (hash ^ static_cast<unsigned char>(*name)) * 16777619u);
+}
+
+/// Tests if the given names are equal. Names whose hashes
+/// match are compared, because a name that isn't known
+/// could collide with a name that is.
+bool isName(const char* name, const char* expected)
+{
+	return std::strcmp(name, expected) == 0;
+}
+
+// Constants that define XML node names. These are constexpr,
+// so their hashes can be used as case labels.
+constexpr const char* AnimatedSpriteNodeName = "AnimatedSprite";
+constexpr const char* PlayerNodeName = "Player";
+constexpr const char* SpriteNodeName = "Sprite";
+constexpr const char* BoxNodeName = "Box";
+constexpr const char* GroupNodeName = "Group";
+constexpr const char* ProjectileNodeName = "Projectile";
+constexpr const char* ShipNodeName = "Ship";
+constexpr const char* ObstacleNodeName = "Obstacle";
+constexpr const char* AssetsTableNodeName = "Assets";
+constexpr const char* TextureTableNodeName = "Textures";
+constexpr const char* SoundsTableNodeName = "Sounds";
+constexpr const char* MusicTableNodeName = "Music";
+constexpr const char* FontsTableNodeName = "Fonts";
+constexpr const char* DecorTableNodeName = "Decor";
+constexpr const char* BackgroundTableNodeName = "Background";
+constexpr const char* TimelineNodeName = "Timeline";
+constexpr const char* SpawnNodeName = "Spawn";
+constexpr const char* DeadlineNodeName = "Deadline";
+constexpr const char* PermanentNodeName = "Permanent";
+constexpr const char* ConcurrentNodeName = "Concurrent";
+constexpr const char* ControllersNodeName = "Controllers";
+constexpr const char* ShowNodeName = "Show";
+constexpr const char* WaveNodeName = "Wave";
+constexpr const char* ConditionNodeName = "Condition";
+constexpr const char* ThenNodeName = "Then";
+constexpr const char* ElseNodeName = "Else";
+constexpr const char* RibbonParticleNodeName = "RibbonParticle";
+constexpr const char* ParticleEmitterNodeName = "ParticleEmitter";
+constexpr const char* FramecounterNodeName = "Framecounter";
+constexpr const char* TextNodeName = "Text";
+constexpr const char* GravityNodeName = "Gravity";
+constexpr const char* LoopNodeName = "Loop";
+constexpr const char* BackgroundNodeName = "Background";
+constexpr const char* MainNodeName = "Main";
+constexpr const char* ExtraNodeName = "Extra";
+constexpr const char* SoundNodeName = "Sound";
+constexpr const char* MusicNodeName = "Music";
+constexpr const char* SetFlagNodeName = "SetFlag";
+constexpr const char* OnLeaveNodeName = "OnLeave";
+constexpr const char* OnEnterNodeName = "OnEnter";
+constexpr const char* WaitNodeName = "Wait";
+constexpr const char* ControlsTableNodeName = "Controls";
 
 // Constants that define XML attribute names.
 const char* const IdAttributeName = "id";
@@ -215,151 +287,274 @@ const char* const TextAttributeName = "text";
 const char* const DurationAttributeName = "duration";
 const char* const RowsAttributeName = "rows";
 const char* const ColumnsAttributeName = "columns";
+const char* const SpawnBudgetAttributeName = "spawnBudget";
+const char* const RigidAttributeName = "rigid";
+const char* const LayerAttributeName = "layer";
+const char* const CollidesWithAttributeName = "collidesWith";
 const char* const PredicateAttributeName = "predicate";
 const char* const SpeedAttributeName = "speed";
 const char* const GravitationalConstantAttributeName = "G";
 const char* const FalloffConstantAttributeName = "falloff";
 const char* const MusicAttributeName = "music";
 const char* const SoundAttributeName = "sound";
+const char* const PriorityAttributeName = "priority";
+const char* const MaxInstancesAttributeName = "maxInstances";
+const char* const VolumeAttributeName = "volume";
 const char* const FlagAttributeName = "flag";
 const char* const ValueAttributeName = "value";
 const char* const MaxIterationCountAttributeName = "maxIterations";
 const char* const FrameCountAttributeName = "frameCount";
 const char* const CycleDurationAttributeName = "cycleDuration";
+const char* const StreamAttributeName = "stream";
+const char* const OnDemandAttributeName = "onDemand";
+const char* const FrameRateAttributeName = "fps";
+const char* const PrewarmAttributeName = "prewarm";
+const char* const SeedAttributeName = "seed";
+const char* const KeyAttributeName = "key";
+const char* const ActionAttributeName = "action";
 
 // Default game bounds. Anything that exceeds these bounds
 // will be removed from the game.
 const DoubleRect GameBounds{ -0.25, -0.25, 1.5, 1.5 };
 
 /// Reads all texture assets defined in this
-/// scene description document.
-std::map<std::string, std::shared_ptr<sf::Texture>> SceneDescription::readTextures() const
+/// scene description document. Textures are
+/// decoded once they are first used.
+std::unordered_map<std::string, LazyAsset<std::shared_ptr<sf::Texture>>> SceneDescription::readTextures(
+	const std::shared_ptr<AssetLoader>& loader) const
 {
-	std::map<std::string, std::shared_ptr<sf::Texture>> results;
-	auto textureNode = this->getTexturesNode();
-	if (textureNode == nullptr)
-		return results;
-	for (auto child = textureNode->FirstChildElement();
-		 child != nullptr;
-		 child = child->NextSiblingElement())
+	std::unordered_map<std::string, LazyAsset<std::shared_ptr<sf::Texture>>> results;
+	this->forEachSectionChild(TextureTableNodeName, [&](const tinyxml2::XMLElement* child)
 	{
 		std::string name = getAttribute(child, IdAttributeName);
 		std::string path = getAttribute(child, PathAttributeName);
-		auto tex = std::make_shared<sf::Texture>();
-		if (!tex->loadFromFile(path))
+		// Streamed textures are never critical: the scene can
+		// start before they have been loaded.
+		bool isStreamed = getBooleanAttribute(child, StreamAttributeName, false);
+		LazyAsset<std::shared_ptr<sf::Texture>> texture([loader, path, isStreamed](bool isCritical)
 		{
-			throw SceneDescriptionException("Couldn't load texture file '" + path + "'.");
-		}
-		results[name] = tex;
-	}
+			return loader->loadTexture(path, isCritical && !isStreamed);
+		});
+
+		// Prewarmed textures are loaded along with the scene,
+		// even if nothing uses them yet.
+		if (getBooleanAttribute(child, PrewarmAttributeName, false))
+			texture.get(true);
+
+		results.erase(name);
+		results.emplace(name, texture);
+	});
 	return results;
 }
 
 /// Reads all font assets defined in this
-/// scene description document.
-std::map<std::string, sf::Font> SceneDescription::readFonts() const
+/// scene description document. Fonts are
+/// shared through the asset cache.
+std::unordered_map<std::string, std::shared_ptr<sf::Font>> SceneDescription::readFonts() const
 {
-	std::map<std::string, sf::Font> results;
-	auto fontsNode = getSingleChild(this->doc.RootElement(), FontsTableNodeName, true);
-	if (fontsNode == nullptr)
-		return results;
-	for (auto child = fontsNode->FirstChildElement();
-		 child != nullptr;
-		 child = child->NextSiblingElement())
+	std::unordered_map<std::string, std::shared_ptr<sf::Font>> results;
+	this->forEachSectionChild(FontsTableNodeName, [&](const tinyxml2::XMLElement* child)
 	{
 		std::string name = getAttribute(child, IdAttributeName);
 		std::string path = getAttribute(child, PathAttributeName);
-		sf::Font fnt;
-		if (!fnt.loadFromFile(path))
-		{
-			throw SceneDescriptionException("Couldn't load font file '" + path + "'.");
-		}
-		results[name] = fnt;
-	}
+		results[name] = AssetCache::instance().loadFont(path);
+	});
 	return results;
 }
 
 /// Reads all sound assets defined in this
 /// scene description document.
-std::map<std::string, std::shared_ptr<sf::SoundBuffer>> SceneDescription::readSounds() const
+std::unordered_map<std::string, SoundAsset> SceneDescription::readSounds(AssetLoader& loader) const
 {
-	std::map<std::string, std::shared_ptr<sf::SoundBuffer>> results;
-	auto soundsNode = getSingleChild(this->doc.RootElement(), SoundsTableNodeName, true);
-	if (soundsNode == nullptr)
-		return results;
-	for (auto child = soundsNode->FirstChildElement();
-		 child != nullptr;
-		 child = child->NextSiblingElement())
+	struct DecodedSound
+	{
+		std::string name;
+		std::string path;
+		bool isCritical;
+		sf::Time duration;
+	};
+
+	std::unordered_map<std::string, SoundAsset> results;
+	std::vector<DecodedSound> decodedSounds;
+	this->forEachSectionChild(SoundsTableNodeName, [&](const tinyxml2::XMLElement* child)
 	{
 		std::string name = getAttribute(child, IdAttributeName);
 		std::string path = getAttribute(child, PathAttributeName);
-		auto sound = std::make_shared<sf::SoundBuffer>();
-		if (!sound->loadFromFile(path))
+		if (getBooleanAttribute(child, OnDemandAttributeName, false))
+		{
+			// Keep the sound's file in memory, and decode it
+			// when it is played. Open the file right away, to
+			// find out if it can be decoded at all.
+			auto encoded = std::make_shared<EncodedSound>();
+			encoded->path = path;
+			encoded->contents = AssetCache::instance().readEncodedSound(path);
+			sf::InputSoundFile file;
+			if (!file.openFromMemory(encoded->contents->data(), encoded->contents->size()))
+			{
+				throw SceneDescriptionException("Couldn't load audio file '" + path + "'.");
+			}
+			encoded->duration = file.getDuration();
+			results.erase(name);
+			results.emplace(name, SoundAsset(std::shared_ptr<const EncodedSound>(encoded)));
+		}
+		else
 		{
-			throw SceneDescriptionException("Couldn't load audio file '" + path + "'.");
+			bool isCritical = !getBooleanAttribute(child, StreamAttributeName, false);
+			// Read the sound's length from its file's header. Sound
+			// events last as long as their sound, so the length must
+			// not depend on when the loader gets around to the sound.
+			// Files that can't be opened are reported by the loader.
+			sf::InputSoundFile file;
+			sf::Time duration;
+			if (file.openFromFile(path))
+				duration = file.getDuration();
+			decodedSounds.push_back(DecodedSound { name, path, isCritical, duration });
 		}
-		results[name] = sound;
+	});
+
+	// Sounds are queued only after the on-demand sounds have been
+	// opened on this thread, because the asset loader's workers
+	// might otherwise open a sound file at the same time.
+	for (const auto& item : decodedSounds)
+	{
+		results.erase(item.name);
+		results.emplace(item.name, SoundAsset(loader.loadSound(item.path, item.isCritical), item.duration));
 	}
 	return results;
 }
 
 /// Reads all music assets defined in this scene
 /// description document.
-std::map<std::string, std::shared_ptr<sf::Music>> SceneDescription::readMusic() const
+std::unordered_map<std::string, std::shared_ptr<sf::Music>> SceneDescription::readMusic() const
 {
-	std::map<std::string, std::shared_ptr<sf::Music>> results;
-	auto soundsNode = getSingleChild(this->doc.RootElement(), MusicTableNodeName, true);
-	if (soundsNode == nullptr)
-		return results;
-	for (auto child = soundsNode->FirstChildElement();
-		 child != nullptr;
-		 child = child->NextSiblingElement())
+	std::unordered_map<std::string, std::shared_ptr<sf::Music>> results;
+	this->forEachSectionChild(MusicTableNodeName, [&](const tinyxml2::XMLElement* child)
 	{
 		std::string name = getAttribute(child, IdAttributeName);
 		std::string path = getAttribute(child, PathAttributeName);
-		auto sound = std::make_shared<sf::Music>();
-		if (!sound->openFromFile(path))
+		results[name] = AssetCache::instance().openMusic(path);
+	});
+	return results;
+}
+
+/// Gets the paths of all asset files that this
+/// scene description refers to.
+std::vector<std::string> SceneDescription::getAssetPaths() const
+{
+	std::vector<std::string> results;
+	const char* tableNames[] =
+	{
+		TextureTableNodeName, FontsTableNodeName, SoundsTableNodeName, MusicTableNodeName
+	};
+	for (auto tableName : tableNames)
+	{
+		this->forEachSectionChild(tableName, [&](const tinyxml2::XMLElement* child)
 		{
-			throw SceneDescriptionException("Couldn't load audio file '" + path + "'.");
-		}
-		results[name] = sound;
+			results.push_back(getAttribute(child, PathAttributeName));
+		});
 	}
 	return results;
 }
 
+/// Tries to read the seed for the random generator that
+/// this scene description specifies.
+bool SceneDescription::tryGetSeed(std::uint32_t& result) const
+{
+	auto rootElem = this->doc.RootElement();
+	unsigned int seed;
+	switch (rootElem->QueryUnsignedAttribute(SeedAttributeName, &seed))
+	{
+	case tinyxml2::XML_NO_ATTRIBUTE:
+		return false;
+	case tinyxml2::XML_WRONG_ATTRIBUTE_TYPE:
+		throw SceneDescriptionException(
+			"'" + std::string(rootElem->Name()) +
+			"' node did have a '" + SeedAttributeName +
+			"' attribute, but its value was not formatted as an unsigned integer number.");
+	default:
+		result = static_cast<std::uint32_t>(seed);
+		return true;
+	}
+}
+
 /// Reads all resources defined in this
 /// scene description document.
-SceneResources SceneDescription::readResources() const
+SceneResources SceneDescription::readResources(const std::shared_ptr<AssetLoader>& loader) const
 {
-	return{ this->readTextures(), this->readFonts(),
-			this->readSounds(), this->readMusic() };
+	SceneResources results;
+	// Textures are queued first, so that they can be decoded
+	// while fonts and music are being opened on this thread.
+	results.textures = this->readTextures(loader);
+	results.fonts = this->readFonts();
+	// Music is opened before any sounds are queued, because
+	// the first sound file to be opened makes SFML register
+	// its sound file readers, which is not thread-safe.
+	results.music = this->readMusic();
+	results.sounds = this->readSounds(*loader);
+	return results;
 }
 
-/// Reads all renderable elements definitions in this
-/// scene description document.
-std::map<std::string, Factory<si::view::IRenderable_ptr>> SceneDescription::readRenderables(
-	const SceneResources& resources) const
+/// Reads the key bindings that this scene description
+/// document defines in its (optional) controls section.
+KeyBindings SceneDescription::readKeyBindings() const
 {
-	std::map<std::string, Factory<si::view::IRenderable_ptr>> results;
-	auto node = this->getRenderablesNode();
-	if (node == nullptr)
-	{
-		return results;
-	}
+	// A controls section replaces the default key
+	// bindings altogether.
+	KeyBindings results;
+	bool hasControls = this->forEachSectionChild(ControlsTableNodeName, [&](const tinyxml2::XMLElement* child)
+	{
+		auto keyName = getAttribute(child, KeyAttributeName);
+		auto actionName = getAttribute(child, ActionAttributeName);
+		sf::Keyboard::Key key;
+		PlayerAction action;
+		if (!KeyBindings::tryParseKey(keyName, key))
+		{
+			throw SceneDescriptionException(
+				"'" + std::string(child->Name()) + "' node's '" + KeyAttributeName +
+				"' attribute has a value of '" + keyName + "', which is not a known key.");
+		}
+		if (!KeyBindings::tryParseAction(actionName, action))
+		{
+			throw SceneDescriptionException(
+				"'" + std::string(child->Name()) + "' node's '" + ActionAttributeName +
+				"' attribute has a value of '" + actionName + "', which is not a known action. " +
+				"Expected 'forward', 'backward', 'left', 'right' or 'fire'.");
+		}
+		results.bind(key, action);
+	});
+	return hasControls ? results : KeyBindings::getDefault();
+}
 
-	for (auto child = node->FirstChildElement();
-		 child != nullptr;
-		 child = child->NextSiblingElement())
+/// Reads all renderable elements definitions in this
+/// scene description document. Renderable factories
+/// are created when they are first referenced.
+std::unordered_map<std::string, LazyAsset<Factory<si::view::IRenderable_ptr>>> SceneDescription::readRenderables(
+	const std::shared_ptr<const SceneResources>& resources) const
+{
+	std::unordered_map<std::string, LazyAsset<Factory<si::view::IRenderable_ptr>>> results;
+	this->forEachDeferredSectionChild(AssetsTableNodeName, [&](
+		const tinyxml2::XMLElement* child,
+		const std::function<SceneSection()>& readChild)
 	{
 		auto name = getAttribute(child, IdAttributeName);
-		results[name] = readRenderable(child, resources);
-	}
+		LazyAsset<Factory<si::view::IRenderable_ptr>> renderable([resources, readChild](bool isCritical)
+		{
+			auto section = readChild();
+			return readRenderable(section.node, *resources, isCritical);
+		});
+
+		if (getBooleanAttribute(child, PrewarmAttributeName, false))
+			renderable.get(true);
+
+		results.erase(name);
+		results.emplace(name, renderable);
+	});
 
 	return results;
 }
 
 /// Reads the scene described by this document.
-std::unique_ptr<Scene> SceneDescription::readScene() const
+std::unique_ptr<Scene> SceneDescription::readScene(const LoadProgressCallback& progress) const
 {
 	auto rootElem = this->doc.RootElement();
 
@@ -368,54 +563,76 @@ std::unique_ptr<Scene> SceneDescription::readScene() const
 		getRangeIntAttribute(rootElem, WidthAttributeName, 800, 1, 4000),
 		getRangeIntAttribute(rootElem, HeightAttributeName, 800, 1, 4000));
 
-	// Start by reading all resources and assets (renderable view elements).
-	auto resources = this->readResources();
-	SceneAssets assets = { this->readRenderables(resources), resources.sounds, resources.music };
-
 	auto scene = std::make_unique<Scene>(name, screenSize);
+	scene->setFrameRate(static_cast<unsigned int>(
+		getRangeIntAttribute(rootElem, FrameRateAttributeName, 0, 0, 1000)));
+	scene->setKeyBindings(this->readKeyBindings());
+
+	// Read all resources and assets (renderable view elements).
+	// Flag names are interned in the scene's flag set.
+	auto loader = std::make_shared<AssetLoader>();
+	loader->setProgressCallback(progress);
+	// Textures and renderables are created when they are
+	// first referenced, so assets that the scene never uses
+	// are never loaded. Assets that the player, the background,
+	// the decor or the first timeline event refer to are
+	// critical: the scene waits for them before it starts.
+	auto resources = std::make_shared<const SceneResources>(this->readResources(loader));
+	SceneAssets assets = {
+		this->readRenderables(resources), resources->sounds, resources->music,
+		scene->getFlags(), scene->getCollisionLayers(), true
+	};
 
 	// Find and parse the player node, then add it to the
 	// scene.
-	auto playerNode = getSingleChild(rootElem, PlayerNodeName);
-	addPlayerToScene(playerNode, assets, *scene);
+	auto playerSection = this->getSection(PlayerNodeName, false);
+	addPlayerToScene(playerSection.node, assets, *scene);
 
-	// Lookup the (optional) background table.
-	auto backgroundNode = getSingleChild(rootElem, BackgroundTableNodeName, true);
-	if (backgroundNode != nullptr)
+	// Lookup the (optional) background table, and add all
+	// background renderables to the scene.
+	this->forEachSectionChild(BackgroundTableNodeName, [&](const tinyxml2::XMLElement* child)
 	{
-		for (auto child = backgroundNode->FirstChildElement();
-			 child != nullptr;
-			 child = child->NextSiblingElement())
-		{
-			// Add all background renderables to the scene.
-			scene->addRenderable(readAssociatedView(child, assets)());
-		}
-	}
+		scene->addRenderable(readAssociatedView(child, assets)());
+	});
 
-	// Lookup the (optional) decor table.
-	auto decorNode = getSingleChild(rootElem, DecorTableNodeName, true);
-	if (decorNode != nullptr)
+	// Lookup the (optional) decor table, and add all decor
+	// objects to the scene.
+	this->forEachSectionChild(DecorTableNodeName, [&](const tinyxml2::XMLElement* child)
 	{
-		for (auto child = decorNode->FirstChildElement();
-			 child != nullptr;
-			 child = child->NextSiblingElement())
-		{
-			// Add all decor objects to the scene.
-			addToScene(readEntity(child, assets)(), *scene);
-		}
-	}
+		addToScene(readEntity(child, assets)(), *scene);
+	});
 
-	// Parse the timeline node, if any.
-	auto timelineNode = getSingleChild(rootElem, TimelineNodeName, true);
-	if (timelineNode != nullptr)
+	// Parse the timeline node, if any. Its events are parsed
+	// one by one, so streamed scene descriptions never need
+	// to hold the entire timeline in memory.
+	std::vector<EventFactory> timelineEvents;
+	bool hasTimeline = this->forEachSectionChild(TimelineNodeName, [&](const tinyxml2::XMLElement* child)
+	{
+		timelineEvents.push_back(parseTimelineEvent(child, assets));
+		// Assets that are first referenced by later events
+		// are loaded while the scene is running.
+		assets.isCritical = false;
+	});
+	if (hasTimeline)
 	{
 		// We found a timeline. Awesome!
-		// Now let's parse it and add it
-		// to the scene.
-		auto tLine = parseTimeline(timelineNode, assets)();
+		// Now let's add it to the scene.
+		auto tLine = createTimeline(timelineEvents)();
 		scene->startEvent(tLine);
 	}
 
+	loader->finishCritical();
+	if (loader->poll())
+	{
+		// Some non-critical assets are still being loaded.
+		// Finish them between frames.
+		scene->addController(std::make_shared<si::controller::ActionController>(
+			[=](si::model::Game&, duration_t) -> bool
+			{
+				return loader->poll();
+			}));
+	}
+
 	return scene;
 }
 
@@ -424,13 +641,14 @@ Factory<si::view::IRenderable_ptr> SceneDescription::readAssociatedView(
 	const tinyxml2::XMLElement* node,
 	const SceneAssets& assets)
 {
-	return getReferenceAttribute(node, AssetAttributeName, assets.renderables);
+	return getReferenceAttribute(node, AssetAttributeName, assets.renderables, assets.isCritical);
 }
 
 /// Reads a renderable group element specified by the given node.
 Factory<si::view::IRenderable_ptr> SceneDescription::readGroupRenderable(
 	const tinyxml2::XMLElement* node,
-	const SceneResources& resources)
+	const SceneResources& resources,
+	bool isCritical)
 {
 	std::vector<Factory<si::view::IRenderable_ptr>> children;
 
@@ -438,7 +656,7 @@ Factory<si::view::IRenderable_ptr> SceneDescription::readGroupRenderable(
 		 child != nullptr;
 		 child = child->NextSiblingElement())
 	{
-		children.push_back(readRenderable(child, resources));
+		children.push_back(readRenderable(child, resources, isCritical));
 	}
 
 	return [children]()
@@ -456,95 +674,113 @@ Factory<si::view::IRenderable_ptr> SceneDescription::readGroupRenderable(
 /// Reads a renderable element specified by the given node.
 Factory<si::view::IRenderable_ptr> SceneDescription::readRenderable(
 	const tinyxml2::XMLElement* node,
-	const SceneResources& resources)
+	const SceneResources& resources,
+	bool isCritical)
 {
-	std::string nodeName = node->Name();
-	if (nodeName == SpriteNodeName)
+	const char* nodeName = node->Name();
+	switch (hashName(nodeName))
 	{
-		auto tex = getReferenceAttribute(node, TextureAttributeName, resources.textures);
-		auto result = std::make_shared<si::view::SpriteRenderable>(tex);
+	case hashName(SpriteNodeName):
+		if (isName(nodeName, SpriteNodeName))
+		{
+			auto tex = getReferenceAttribute(node, TextureAttributeName, resources.textures, isCritical);
+			auto result = std::make_shared<si::view::SpriteRenderable>(tex);
 
-		return [result]() { return result; };
-	}
-	else if (nodeName == AnimatedSpriteNodeName)
-	{
-		auto tex = getReferenceAttribute(node, TextureAttributeName, resources.textures);
-		int frameCount = getIntAttribute(node, FrameCountAttributeName);
-		duration_t cycleDuration(getDoubleAttribute(node, CycleDurationAttributeName, 0.2));
+			return [result]() { return result; };
+		}
+		break;
+	case hashName(AnimatedSpriteNodeName):
+		if (isName(nodeName, AnimatedSpriteNodeName))
+		{
+			auto tex = getReferenceAttribute(node, TextureAttributeName, resources.textures, isCritical);
+			int frameCount = getIntAttribute(node, FrameCountAttributeName);
+			duration_t cycleDuration(getDoubleAttribute(node, CycleDurationAttributeName, 0.2));
 
-		return [=]()
+			return [=]()
+			{
+				return std::make_shared<si::view::AnimatedSpriteRenderable>(
+					tex, frameCount, cycleDuration);
+			};
+		}
+		break;
+	case hashName(RibbonParticleNodeName):
+		if (isName(nodeName, RibbonParticleNodeName))
 		{
-			return std::make_shared<si::view::AnimatedSpriteRenderable>(
-				tex, frameCount, cycleDuration);
-		};
-	}
-	else if (nodeName == RibbonParticleNodeName)
-	{
-		auto color = getColorAttribute(node);
-		duration_t interval(getDoubleAttribute(node, IntervalAttributeName, 0.01));
-		duration_t lifetime(getDoubleAttribute(node, LifetimeAttributeName, 0.5));
+			auto color = getColorAttribute(node);
+			duration_t interval(getDoubleAttribute(node, IntervalAttributeName, 0.01));
+			duration_t lifetime(getDoubleAttribute(node, LifetimeAttributeName, 0.5));
 
-		return [=]()
+			return [=]()
+			{
+				return std::make_shared<si::view::RibbonParticleRenderable>(color, interval, lifetime);
+			};
+		}
+		break;
+	case hashName(ParticleEmitterNodeName):
+		if (isName(nodeName, ParticleEmitterNodeName))
 		{
-			return std::make_shared<si::view::RibbonParticleRenderable>(color, interval, lifetime);
-		};
-	}
-	else if (nodeName == ParticleEmitterNodeName)
-	{
-		auto particleFactory = readRenderable(getSingleChild(node), resources);
-		double speed = getDoubleAttribute(node, SpeedAttributeName, 0.01);
-		duration_t interval(getDoubleAttribute(node, IntervalAttributeName, 0.01));
-		duration_t lifetime(getDoubleAttribute(node, LifetimeAttributeName, 0.5));
+			auto particleFactory = readRenderable(getSingleChild(node), resources, isCritical);
+			double speed = getDoubleAttribute(node, SpeedAttributeName, 0.01);
+			duration_t interval(getDoubleAttribute(node, IntervalAttributeName, 0.01));
+			duration_t lifetime(getDoubleAttribute(node, LifetimeAttributeName, 0.5));
 
-		return [=]()
+			return [=]()
+			{
+				return std::make_shared<si::view::ParticleEmitterRenderable>(
+					particleFactory, speed, interval, lifetime);
+			};
+		}
+		break;
+	case hashName(FramecounterNodeName):
+		if (isName(nodeName, FramecounterNodeName))
 		{
-			return std::make_shared<si::view::ParticleEmitterRenderable>(
-				particleFactory, speed, interval, lifetime);
-		};
-	}
-	else if (nodeName == FramecounterNodeName)
-	{
-		auto color = getColorAttribute(node);
-		auto font = getReferenceAttribute(node, FontAttributeName, resources.fonts);
+			auto color = getColorAttribute(node);
+			auto font = getReferenceAttribute(node, FontAttributeName, resources.fonts);
 
-		return [=]()
+			return [=]()
+			{
+				return std::make_shared<si::view::FramecounterRenderable>(*font, color);
+			};
+		}
+		break;
+	case hashName(TextNodeName):
+		if (isName(nodeName, TextNodeName))
 		{
-			return std::make_shared<si::view::FramecounterRenderable>(font, color);
-		};
-	}
-	else if (nodeName == TextNodeName)
-	{
-		auto color = getColorAttribute(node);
-		auto font = getReferenceAttribute(node, FontAttributeName, resources.fonts);
-		auto text = getAttribute(node, TextAttributeName);
+			auto color = getColorAttribute(node);
+			auto font = getReferenceAttribute(node, FontAttributeName, resources.fonts);
+			auto text = getAttribute(node, TextAttributeName);
 
-		return [=]()
+			return [=]()
+			{
+				return std::make_shared<si::view::TextRenderable>(text, *font, color);
+			};
+		}
+		break;
+	case hashName(BoxNodeName):
+		if (isName(nodeName, BoxNodeName))
 		{
-			return std::make_shared<si::view::TextRenderable>(text, font, color);
-		};
-	}
-	else if (nodeName == BoxNodeName)
-	{
-		double x = getDoubleAttribute(node, PositionXAttributeName, 0.0);
-		double y = getDoubleAttribute(node, PositionYAttributeName, 0.0);
-		double width = getDoubleAttribute(node, WidthAttributeName, 1.0);
-		double height = getDoubleAttribute(node, HeightAttributeName, 1.0);
+			double x = getDoubleAttribute(node, PositionXAttributeName, 0.0);
+			double y = getDoubleAttribute(node, PositionYAttributeName, 0.0);
+			double width = getDoubleAttribute(node, WidthAttributeName, 1.0);
+			double height = getDoubleAttribute(node, HeightAttributeName, 1.0);
 
-		auto contents = readRenderable(getSingleChild(node), resources);
+			auto contents = readRenderable(getSingleChild(node), resources, isCritical);
 
-		return [=]()
+			return [=]()
+			{
+				return std::make_shared<si::view::RelativeBoxRenderable>(contents(), DoubleRect(x, y, width, height));
+			};
+		}
+		break;
+	case hashName(GroupNodeName):
+		if (isName(nodeName, GroupNodeName))
 		{
-			return std::make_shared<si::view::RelativeBoxRenderable>(contents(), DoubleRect(x, y, width, height));
-		};
-	}
-	else if (nodeName == GroupNodeName)
-	{
-		return readGroupRenderable(node, resources);
-	}
-	else
-	{
-		throw SceneDescriptionException("Unexpected node type: '" + nodeName + "'.");
+			return readGroupRenderable(node, resources, isCritical);
+		}
+		break;
 	}
+
+	throw SceneDescriptionException("Unexpected node type: '" + std::string(nodeName) + "'.");
 }
 
 /// Reads an on-enter controller. Its contains-model condition can be
@@ -589,33 +825,40 @@ ControllerBuilder SceneDescription::readController(
 	const tinyxml2::XMLElement* node,
 	const SceneAssets& assets)
 {
-	std::string nodeName = node->Name();
-	if (nodeName == GravityNodeName)
+	const char* nodeName = node->Name();
+	switch (hashName(nodeName))
 	{
-		double gravitationalConstant = getDoubleAttribute(node, GravitationalConstantAttributeName);
-		double falloffConstant = getDoubleAttribute(node, FalloffConstantAttributeName, 2.0);
-
-		return [=](const std::shared_ptr<si::model::PhysicsEntity>& parent) -> UnboundController
+	case hashName(GravityNodeName):
+		if (isName(nodeName, GravityNodeName))
 		{
-			return [=](Scene&) -> si::controller::IController_ptr
+			double gravitationalConstant = getDoubleAttribute(node, GravitationalConstantAttributeName);
+			double falloffConstant = getDoubleAttribute(node, FalloffConstantAttributeName, 2.0);
+
+			return [=](const std::shared_ptr<si::model::PhysicsEntity>& parent) -> UnboundController
 			{
-				return std::make_shared<si::controller::GravityController>(
-					parent, gravitationalConstant, falloffConstant);
+				return [=](Scene&) -> si::controller::IController_ptr
+				{
+					return std::make_shared<si::controller::GravityController>(
+						parent, gravitationalConstant, falloffConstant);
+				};
 			};
-		};
-	}
-	else if (nodeName == OnEnterNodeName)
-	{
-		return readOnEnterController<false>(node, assets);
-	}
-	else if (nodeName == OnLeaveNodeName)
-	{
-		return readOnEnterController<true>(node, assets);
-	}
-	else
-	{
-		throw SceneDescriptionException("Unexpected node type: '" + nodeName + "'.");
+		}
+		break;
+	case hashName(OnEnterNodeName):
+		if (isName(nodeName, OnEnterNodeName))
+		{
+			return readOnEnterController<false>(node, assets);
+		}
+		break;
+	case hashName(OnLeaveNodeName):
+		if (isName(nodeName, OnLeaveNodeName))
+		{
+			return readOnEnterController<true>(node, assets);
+		}
+		break;
 	}
+
+	throw SceneDescriptionException("Unexpected node type: '" + std::string(nodeName) + "'.");
 }
 
 /// Reads the given node's vector of associated controllers.
@@ -640,7 +883,7 @@ std::vector<ControllerBuilder> SceneDescription::readAssociatedControllers(
 
 /// Creates a directed parsed entity from the given parameters.
 /// This logic is common to ships, obstacles and projectiles.
-template<typename TModel, typename TPathController, typename... TArgs>
+template<typename TModel, typename TCollisionController, typename... TArgs>
 static ParsedEntity<TModel> instantiateDirectedEntity(
 	const Factory<si::view::IRenderable_ptr>& view,
 	const std::vector<ControllerBuilder>& associatedControllers,
@@ -650,15 +893,14 @@ static ParsedEntity<TModel> instantiateDirectedEntity(
 	std::vector<UnboundController> controllers;
 	controllers.push_back(
 		constantFunction<si::controller::IController_ptr, Scene&>(
-			std::make_shared<TPathController>(model)));
-	controllers.push_back(
-		constantFunction<si::controller::IController_ptr, Scene&>(
-			std::make_shared<si::controller::OutOfBoundsController>(model, GameBounds)));
+			std::make_shared<TCollisionController>(model)));
 	for (const auto& item : associatedControllers)
 	{
 		controllers.push_back(item(model));
 	}
-	return addControllers(createDirectedEntity(model, view()), controllers);
+	return addBoundsConstraint(
+		addControllers(createDirectedEntity(model, view()), controllers),
+		GameBounds);
 }
 
 /// Reads a ship entity as specified by the given node.
@@ -666,7 +908,7 @@ ParsedShipFactory SceneDescription::readShipEntity(
 	const tinyxml2::XMLElement* node,
 	const SceneAssets& assets)
 {
-	auto physProps = getPhysicsProperties(node);
+	auto physProps = getPhysicsProperties(node, assets);
 	Vector2d pos(
 		getDoubleAttribute(node, PositionXAttributeName, 0.5),
 		getDoubleAttribute(node, PositionYAttributeName, 0.5));
@@ -689,7 +931,7 @@ ParsedObstacleFactory SceneDescription::readObstacleEntity(
 	const tinyxml2::XMLElement* node,
 	const SceneAssets& assets)
 {
-	auto physProps = getPhysicsProperties(node);
+	auto physProps = getPhysicsProperties(node, assets);
 	Vector2d pos(
 		getDoubleAttribute(node, PositionXAttributeName, 0.5),
 		getDoubleAttribute(node, PositionYAttributeName, 0.5));
@@ -727,15 +969,16 @@ void SceneDescription::addPlayerToScene(
 	// Register the player, and throw in a player
 	// velocity controller while we're at it.
 	double playerAccel = getDoubleAttribute(node, AccelerationAttributeName);
-	scene.addController(std::make_shared<si::controller::PlayerController>(player.model, playerAccel));
+	scene.addController(std::make_shared<si::controller::PlayerController>(
+		player.model, playerAccel, scene.getInput()), player.model);
 
 	// Create a player projectile controller for this ship.
 	double fireInterval = getDoubleAttribute(node, FireIntervalAttributeName);
 	auto projectileFactory = readProjectileEntity(getSingleChild(node, ProjectileNodeName), assets);
 	scene.addController(std::make_shared<si::controller::IntervalActionController>(si::duration_t(fireInterval),
-		[](const si::model::Game&, si::duration_t) -> bool
+		[&scene](const si::model::Game&, si::duration_t) -> bool
 		{
-			return sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+			return scene.getInput().isActive(si::PlayerAction::Fire);
 		},
 		[player, projectileFactory, &scene](si::model::Game&, si::duration_t) -> void
 		{
@@ -744,7 +987,7 @@ void SceneDescription::addPlayerToScene(
 		[=](const si::model::Game&, si::duration_t) -> bool
 		{
 			return player.model->isAlive();
-		}));
+		}), player.model);
 }
 
 /// Reads a projectile entity as specified by the given node.
@@ -755,7 +998,7 @@ ParsedDriftingEntityFactory SceneDescription::readProjectileEntity(
 	const tinyxml2::XMLElement* node,
 	const SceneAssets& assets)
 {
-	auto physProps = getPhysicsProperties(node);
+	auto physProps = getPhysicsProperties(node, assets);
 	Vector2d pos(
 		getDoubleAttribute(node, PositionXAttributeName, 0.0),
 		getDoubleAttribute(node, PositionYAttributeName, 0.0));
@@ -779,23 +1022,30 @@ ParsedEntityFactory<si::model::Entity> SceneDescription::readEntity(
 	const tinyxml2::XMLElement* node,
 	const SceneAssets& assets)
 {
-	std::string nodeName = node->Name();
-	if (nodeName == ShipNodeName)
-	{
-		return readShipEntity(node, assets);
-	}
-	else if (nodeName == ProjectileNodeName)
-	{
-		return readProjectileEntity(node, assets);
-	}
-	else if (nodeName == ObstacleNodeName)
+	const char* nodeName = node->Name();
+	switch (hashName(nodeName))
 	{
-		return readObstacleEntity(node, assets);
-	}
-	else
-	{
-		throw SceneDescriptionException("Unexpected node type: '" + nodeName + "'.");
+	case hashName(ShipNodeName):
+		if (isName(nodeName, ShipNodeName))
+		{
+			return readShipEntity(node, assets);
+		}
+		break;
+	case hashName(ProjectileNodeName):
+		if (isName(nodeName, ProjectileNodeName))
+		{
+			return readProjectileEntity(node, assets);
+		}
+		break;
+	case hashName(ObstacleNodeName):
+		if (isName(nodeName, ObstacleNodeName))
+		{
+			return readObstacleEntity(node, assets);
+		}
+		break;
 	}
+
+	throw SceneDescriptionException("Unexpected node type: '" + std::string(nodeName) + "'.");
 }
 
 /// Reads a timeline as specified by the given node.
@@ -815,6 +1065,13 @@ EventFactory SceneDescription::parseTimeline(
 		events.push_back(parseTimelineEvent(child, assets));
 	}
 
+	return createTimeline(events);
+}
+
+/// Creates a timeline that runs the events created by
+/// the given factories in sequence.
+EventFactory SceneDescription::createTimeline(const std::vector<EventFactory>& events)
+{
 	return [=]()
 	{
 		std::vector<si::timeline::ITimelineEvent_ptr> children;
@@ -877,6 +1134,7 @@ EventFactory SceneDescription::parseWaveEvent(
 	double velX = getDoubleAttribute(shipNode, VelocityXAttributeName, 0.05);
 	double velY = getDoubleAttribute(shipNode, VelocityYAttributeName, 0.05);
 	double springConst = getDoubleAttribute(shipNode, SpringConstantAttributeName, 5.0);
+	bool isRigid = getBooleanAttribute(node, RigidAttributeName, false);
 	si::duration_t fireInterval(getDoubleAttribute(shipNode, FireIntervalAttributeName, 1.0));
 	si::duration_t maxDeviation(getDoubleAttribute(shipNode, FireIntervalDeviationAttributeName, 0.0));
 	double posX = getDoubleAttribute(node, PositionXAttributeName, 0.5);
@@ -885,11 +1143,15 @@ EventFactory SceneDescription::parseWaveEvent(
 	double dirY = getDoubleAttribute(node, DirectionYAttributeName, 1.0);
 	double spacingX = getDoubleAttribute(node, SpacingXAttributeName, 0.05);
 	double spacingY = getDoubleAttribute(node, SpacingYAttributeName, 0.05);
+	int spawnBudget = getRangeIntAttribute(
+		node, SpawnBudgetAttributeName,
+		static_cast<int>(si::timeline::InvaderWaveEvent::DefaultSpawnBudget), 0, 10000);
 
 	si::timeline::InvaderBehavior behavior =
 	{
-		Vector2d(velX, velY), springConst, fireInterval, maxDeviation,
-		Vector2d(posX, posY), Vector2d(dirX, dirY), Vector2d(spacingX, spacingY)
+		Vector2d(velX, velY), springConst, isRigid, fireInterval, maxDeviation,
+		Vector2d(posX, posY), Vector2d(dirX, dirY), Vector2d(spacingX, spacingY),
+		static_cast<std::size_t>(spawnBudget)
 	};
 
 	return [=]()
@@ -908,15 +1170,14 @@ EventFactory SceneDescription::parseConditionalEvent(
 	if (node == nullptr)
 		return si::timeline::emptyTimeline;
 
-	std::string attr = getAttribute(node, PredicateAttributeName);
-	auto condition = [=](const Scene& scene) { return scene.getFlag(attr); };
+	auto flag = assets.flags.intern(getAttribute(node, PredicateAttributeName));
 
 	auto ifEvent = parseTimelineEvent(getSingleChild(getSingleChild(node, ThenNodeName)), assets);
 	auto elseEvent = parseTimelineEvent(getSingleChild(getSingleChild(node, ElseNodeName)), assets);
 
 	return [=]()
 	{
-		return std::make_shared<si::timeline::ConditionalEvent>(condition, ifEvent(), elseEvent());
+		return std::make_shared<si::timeline::ConditionalEvent>(flag, ifEvent(), elseEvent());
 	};
 }
 
@@ -928,113 +1189,153 @@ EventFactory SceneDescription::parseTimelineEvent(
 	if (node == nullptr)
 		return si::timeline::emptyTimeline;
 
-	std::string nodeName = node->Name();
-	if (nodeName == TimelineNodeName)
-	{
-		return parseTimeline(node, assets);
-	}
-	else if (nodeName == SpawnNodeName)
+	const char* nodeName = node->Name();
+	switch (hashName(nodeName))
 	{
-		auto factory = readEntity(getSingleChild(node), assets);
-		return [=]()
+	case hashName(TimelineNodeName):
+		if (isName(nodeName, TimelineNodeName))
 		{
-			return factory().creationEvent;
-		};
-	}
-	else if (nodeName == ShowNodeName)
-	{
-		auto factory = getReferenceAttribute(node, AssetAttributeName, assets.renderables);
-		return [=]()
+			return parseTimeline(node, assets);
+		}
+		break;
+	case hashName(SpawnNodeName):
+		if (isName(nodeName, SpawnNodeName))
 		{
-			return std::make_shared<si::timeline::ShowEvent>(factory);
-		};
-	}
-	else if (nodeName == WaveNodeName)
-	{
-		return parseWaveEvent(node, assets);
-	}
-	else if (nodeName == WaitNodeName)
-	{
-		return [=]()
+			auto factory = readEntity(getSingleChild(node), assets);
+			return [=]()
+			{
+				return factory().creationEvent;
+			};
+		}
+		break;
+	case hashName(ShowNodeName):
+		if (isName(nodeName, ShowNodeName))
 		{
-			auto inner = std::make_shared<si::timeline::Timeline>();
-			return std::make_shared<si::timeline::LoopedEvent>(inner);
-		};
-	}
-	else if (nodeName == DeadlineNodeName)
-	{
-		duration_t duration(getDoubleAttribute(node, DurationAttributeName));
-		auto inner = parseTimelineEvent(getSingleChild(node), assets);
-		return [=]()
+			auto factory = getReferenceAttribute(node, AssetAttributeName, assets.renderables, assets.isCritical);
+			return [=]()
+			{
+				return std::make_shared<si::timeline::ShowEvent>(factory);
+			};
+		}
+		break;
+	case hashName(WaveNodeName):
+		if (isName(nodeName, WaveNodeName))
 		{
-			return std::make_shared<si::timeline::DeadlineEvent>(inner(), duration);
-		};
-	}
-	else if (nodeName == PermanentNodeName)
-	{
-		auto inner = parseTimelineEvent(getSingleChild(node), assets);
-		return [=]()
+			return parseWaveEvent(node, assets);
+		}
+		break;
+	case hashName(WaitNodeName):
+		if (isName(nodeName, WaitNodeName))
 		{
-			return std::make_shared<si::timeline::PermanentEvent>(inner());
-		};
-	}
-	else if (nodeName == LoopNodeName)
-	{
-		auto inner = parseTimelineEvent(getSingleChild(node), assets);
-		int maxIterationCount = getIntAttribute(node, MaxIterationCountAttributeName, 0);
-		return [=]()
+			return [=]()
+			{
+				auto inner = std::make_shared<si::timeline::Timeline>();
+				return std::make_shared<si::timeline::LoopedEvent>(inner);
+			};
+		}
+		break;
+	case hashName(DeadlineNodeName):
+		if (isName(nodeName, DeadlineNodeName))
 		{
-			return std::make_shared<si::timeline::LoopedEvent>(inner(), maxIterationCount);
-		};
-	}
-	else if (nodeName == BackgroundNodeName)
-	{
-		auto mainEvent = parseTimelineEvent(getSingleChild(getSingleChild(node, MainNodeName)), assets);
-		auto extraEvent = parseTimelineEvent(getSingleChild(getSingleChild(node, ExtraNodeName)), assets);
-		return [=]()
+			duration_t duration(getDoubleAttribute(node, DurationAttributeName));
+			auto inner = parseTimelineEvent(getSingleChild(node), assets);
+			return [=]()
+			{
+				return std::make_shared<si::timeline::DeadlineEvent>(inner(), duration);
+			};
+		}
+		break;
+	case hashName(PermanentNodeName):
+		if (isName(nodeName, PermanentNodeName))
 		{
-			return std::make_shared<si::timeline::BackgroundEvent>(mainEvent(), extraEvent());
-		};
-	}
-	else if (nodeName == SoundNodeName)
-	{
-		auto sound = getReferenceAttribute(node, SoundAttributeName, assets.sounds);
-		return [=]()
+			auto inner = parseTimelineEvent(getSingleChild(node), assets);
+			return [=]()
+			{
+				return std::make_shared<si::timeline::PermanentEvent>(inner());
+			};
+		}
+		break;
+	case hashName(LoopNodeName):
+		if (isName(nodeName, LoopNodeName))
 		{
-			return std::make_shared<si::timeline::SoundEvent>(sound);
-		};
-	}
-	else if (nodeName == MusicNodeName)
-	{
-		auto music = getReferenceAttribute(node, MusicAttributeName, assets.music);
-		return [=]()
+			auto inner = parseTimelineEvent(getSingleChild(node), assets);
+			int maxIterationCount = getIntAttribute(node, MaxIterationCountAttributeName, 0);
+			return [=]()
+			{
+				return std::make_shared<si::timeline::LoopedEvent>(inner(), maxIterationCount);
+			};
+		}
+		break;
+	case hashName(BackgroundNodeName):
+		if (isName(nodeName, BackgroundNodeName))
 		{
-			return std::make_shared<si::timeline::MusicEvent>(music);
-		};
-	}
-	else if (nodeName == SetFlagNodeName)
-	{
-		auto flagName = getAttribute(node, FlagAttributeName);
-		auto flagValue = getBooleanAttribute(node, ValueAttributeName);
+			auto mainEvent = parseTimelineEvent(getSingleChild(getSingleChild(node, MainNodeName)), assets);
+			auto extraEvent = parseTimelineEvent(getSingleChild(getSingleChild(node, ExtraNodeName)), assets);
+			return [=]()
+			{
+				return std::make_shared<si::timeline::BackgroundEvent>(mainEvent(), extraEvent());
+			};
+		}
+		break;
+	case hashName(SoundNodeName):
+		if (isName(nodeName, SoundNodeName))
+		{
+			auto sound = getReferenceAttribute(node, SoundAttributeName, assets.sounds);
+			int maxInstances = getIntAttribute(node, MaxInstancesAttributeName, 0);
+			if (maxInstances < 0)
+			{
+				throw SceneDescriptionException(
+					"'" + std::string(node->Name()) + "' node's '" + MaxInstancesAttributeName +
+					"' attribute must not be negative.");
+			}
+			si::timeline::SoundProperties soundProps(
+				getIntAttribute(node, PriorityAttributeName, 0),
+				static_cast<std::size_t>(maxInstances),
+				static_cast<float>(getDoubleAttribute(node, VolumeAttributeName, 100.0)));
+			return [=]()
+			{
+				return std::make_shared<si::timeline::SoundEvent>(sound, soundProps);
+			};
+		}
+		break;
+	case hashName(MusicNodeName):
+		if (isName(nodeName, MusicNodeName))
+		{
+			auto music = getReferenceAttribute(node, MusicAttributeName, assets.music);
+			return [=]()
+			{
+				return std::make_shared<si::timeline::MusicEvent>(music);
+			};
+		}
+		break;
+	case hashName(SetFlagNodeName):
+		if (isName(nodeName, SetFlagNodeName))
+		{
+			auto flag = assets.flags.intern(getAttribute(node, FlagAttributeName));
+			auto flagValue = getBooleanAttribute(node, ValueAttributeName);
 
-		return [=]()
+			return [=]()
+			{
+				return std::make_shared<si::timeline::InstantaneousEvent>(
+					[=](Scene& target) { target.setFlag(flag, flagValue); });
+			};
+		}
+		break;
+	case hashName(ConcurrentNodeName):
+		if (isName(nodeName, ConcurrentNodeName))
 		{
-			return std::make_shared<si::timeline::InstantaneousEvent>(
-				[=](Scene& target) { target.setFlag(flagName, flagValue); });
-		};
-	}
-	else if (nodeName == ConcurrentNodeName)
-	{
-		return parseConcurrentEvent(node, assets);
-	}
-	else if (nodeName == ConditionNodeName)
-	{
-		return parseConditionalEvent(node, assets);
-	}
-	else
-	{
-		throw SceneDescriptionException("Unexpected node type: '" + nodeName + "'.");
+			return parseConcurrentEvent(node, assets);
+		}
+		break;
+	case hashName(ConditionNodeName):
+		if (isName(nodeName, ConditionNodeName))
+		{
+			return parseConditionalEvent(node, assets);
+		}
+		break;
 	}
+
+	throw SceneDescriptionException("Unexpected node type: '" + std::string(nodeName) + "'.");
 }
 
 /// Reads a timed "show" event as specified by the given node.
@@ -1051,7 +1352,7 @@ EntityEventBuilder SceneDescription::parseTimedShowEvent(
 		};
 	}
 
-	auto asset = getReferenceAttribute(node, AssetAttributeName, assets.renderables);
+	auto asset = getReferenceAttribute(node, AssetAttributeName, assets.renderables, assets.isCritical);
 	duration_t time(getDoubleAttribute(node, DurationAttributeName));
 
 	return [=](const std::shared_ptr<si::model::PhysicsEntity>& parent) -> si::timeline::ITimelineEvent_ptr
@@ -1241,6 +1542,18 @@ bool SceneDescription::getBooleanAttribute(const tinyxml2::XMLElement* node, con
 			" was neither 'true' nor 'false'. Expected a boolean nonetheless.");
 }
 
+/// Gets the value of the boolean attribute with the given
+/// name in the given XML node.
+/// If no such attribute can be found, the given default
+/// value is returned as a result.
+bool SceneDescription::getBooleanAttribute(const tinyxml2::XMLElement* node, const char* name, bool defaultValue)
+{
+	if (node->Attribute(name) == nullptr)
+		return defaultValue;
+	else
+		return getBooleanAttribute(node, name);
+}
+
 /// Gets a value from the given key-value map
 /// identified by the attribute with the given name
 /// in the given node.
@@ -1249,10 +1562,11 @@ template<typename T>
 T SceneDescription::getReferenceAttribute(
 	const tinyxml2::XMLElement* node,
 	const char* attributeName,
-	const std::map<std::string, T>& map)
+	const std::unordered_map<std::string, T>& map)
 {
 	std::string attr = getAttribute(node, attributeName);
-	if (map.find(attr) == map.end())
+	auto pos = map.find(attr);
+	if (pos == map.end())
 	{
 		throw SceneDescriptionException(
 			"This '" + std::string(node->Name()) + "' node's '" + std::string(attributeName) +
@@ -1260,17 +1574,67 @@ T SceneDescription::getReferenceAttribute(
 			"', but no appropriate element could be found for '" + attr + "'.");
 	}
 
-	return map.at(attr);
+	return pos->second;
+}
+
+/// Gets the value of a lazy asset from the given key-value
+/// map identified by the attribute with the given name in
+/// the given node.
+/// If something goes wrong, an exception is thrown.
+template<typename T>
+T SceneDescription::getReferenceAttribute(
+	const tinyxml2::XMLElement* node,
+	const char* attributeName,
+	const std::unordered_map<std::string, LazyAsset<T>>& map,
+	bool isCritical)
+{
+	return getReferenceAttribute(node, attributeName, map).get(isCritical);
 }
 
 /// Reads the given node's physics properties.
 si::model::PhysicsProperties SceneDescription::getPhysicsProperties(
-	const tinyxml2::XMLElement* node)
+	const tinyxml2::XMLElement* node,
+	const SceneAssets& assets)
 {
 	double mass = getDoubleAttribute(node, MassAttributeName);
 	double radius = getDoubleAttribute(node, RadiusAttributeName);
 
-	return{ mass, radius };
+	si::model::PhysicsProperties result(mass, radius);
+	result.collisionLayers = getCollisionMaskAttribute(
+		node, LayerAttributeName, assets.collisionLayers,
+		si::model::CollisionLayerSet::DefaultLayer);
+	result.collisionMask = getCollisionMaskAttribute(
+		node, CollidesWithAttributeName, assets.collisionLayers,
+		si::model::CollisionLayerSet::AllLayers);
+	return result;
+}
+
+/// Reads the collision layers that are listed by the
+/// given attribute of the given node, separated by spaces.
+si::model::CollisionMask SceneDescription::getCollisionMaskAttribute(
+	const tinyxml2::XMLElement* node, const char* name,
+	si::model::CollisionLayerSet& layers,
+	si::model::CollisionMask defaultValue)
+{
+	if (node->Attribute(name) == nullptr)
+		return defaultValue;
+
+	si::model::CollisionMask result = 0;
+	std::istringstream stream(getAttribute(node, name));
+	std::string layerName;
+	while (stream >> layerName)
+	{
+		si::model::CollisionMask layer;
+		if (!layers.tryIntern(layerName, layer))
+		{
+			throw SceneDescriptionException(
+				"'" + std::string(node->Name()) + "' node's '" + name +
+				"' attribute has a value of '" + layerName + "', which would make for more than " +
+				std::to_string(si::model::CollisionLayerSet::MaxLayerCount) + " collision layers.");
+		}
+		result |= layer;
+	}
+	return result;
 }
 
 
@@ -1321,22 +1685,174 @@ const tinyxml2::XMLElement* SceneDescription::getSingleChild(const tinyxml2::XML
 	return child;
 }
 
-const tinyxml2::XMLElement* SceneDescription::getTexturesNode() const
+/// Reads the scene description document's text, and finds
+/// its top-level sections. Only the root element's start
+/// tag is parsed.
+void SceneDescription::readSections()
 {
-	return getSingleChild(this->doc.RootElement(), TextureTableNodeName, true);
+	std::ifstream stream(this->path, std::ios::binary);
+	if (!stream)
+	{
+		throw XMLParseException("XML_ERROR_FILE_COULD_NOT_BE_OPENED", this->path, "");
+	}
+	this->text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+	XMLElementText root;
+	XMLElementScanner rootScanner(this->text.data(), this->text.data() + this->text.size());
+	if (!rootScanner.next(root))
+	{
+		throw XMLParseException("XML_ERROR_EMPTY_DOCUMENT", this->path, "");
+	}
+
+	auto rootTag = root.getStartTagAsEmptyElement();
+	this->doc.Parse(rootTag.c_str(), rootTag.size());
+	this->throwError();
+
+	XMLElementText section;
+	XMLElementScanner scanner(root);
+	while (scanner.next(section))
+	{
+		if (!this->sections.insert(std::make_pair(section.name, section)).second)
+			this->duplicateSections.insert(section.name);
+	}
 }
 
-const tinyxml2::XMLElement* SceneDescription::getRenderablesNode() const
+/// Finds the text of the top-level section with the given
+/// name in a streamed scene description.
+const XMLElementText* SceneDescription::findSectionText(const char* name, bool isOptional) const
 {
-	return getSingleChild(this->doc.RootElement(), AssetsTableNodeName, true);
+	std::string rootName = this->doc.RootElement()->Name();
+	auto pos = this->sections.find(name);
+	if (pos == this->sections.end())
+	{
+		if (isOptional)
+			return nullptr;
+
+		throw SceneDescriptionException(
+			"'" + rootName + "' should have had exactly one '" + name + "' child node, but had none.");
+	}
+
+	if (this->duplicateSections.find(name) != this->duplicateSections.end())
+	{
+		throw SceneDescriptionException(
+			"'" + rootName + "' should have had " + (isOptional ? "at most one '" : "exactly one '") +
+			name + "' child node, but has more than one.");
+	}
+
+	return &pos->second;
+}
+
+/// Gets the top-level section with the given name.
+SceneSection SceneDescription::getSection(const char* name, bool isOptional) const
+{
+	if (!this->isStreaming)
+	{
+		return SceneSection { nullptr, getSingleChild(this->doc.RootElement(), name, isOptional) };
+	}
+
+	auto sectionText = this->findSectionText(name, isOptional);
+	if (sectionText == nullptr)
+		return SceneSection { nullptr, nullptr };
+
+	auto sectionDoc = sectionText->parse();
+	auto node = sectionDoc->RootElement();
+	return SceneSection { std::move(sectionDoc), node };
+}
+
+/// Calls the given function for every child element
+/// of the (optional) top-level section with the given
+/// name.
+bool SceneDescription::forEachSectionChild(
+	const char* name,
+	const std::function<void(const tinyxml2::XMLElement*)>& action) const
+{
+	if (!this->isStreaming)
+	{
+		auto node = getSingleChild(this->doc.RootElement(), name, true);
+		if (node == nullptr)
+			return false;
+
+		for (auto child = node->FirstChildElement();
+			 child != nullptr;
+			 child = child->NextSiblingElement())
+		{
+			action(child);
+		}
+		return true;
+	}
+
+	auto sectionText = this->findSectionText(name, true);
+	if (sectionText == nullptr)
+		return false;
+
+	// Parse the section's children one at a time. Each
+	// child's document is freed before the next child is
+	// parsed.
+	XMLElementText child;
+	XMLElementScanner scanner(*sectionText);
+	while (scanner.next(child))
+	{
+		auto childDoc = child.parse();
+		action(childDoc->RootElement());
+	}
+	return true;
+}
+
+/// Calls the given function for every child element
+/// of the (optional) top-level section with the given
+/// name. The function is also given a function that
+/// reads the complete child element.
+void SceneDescription::forEachDeferredSectionChild(
+	const char* name,
+	const std::function<void(
+		const tinyxml2::XMLElement*,
+		const std::function<SceneSection()>&)>& action) const
+{
+	if (!this->isStreaming)
+	{
+		this->forEachSectionChild(name, [&](const tinyxml2::XMLElement* child)
+		{
+			action(child, [child]() { return SceneSection { nullptr, child }; });
+		});
+		return;
+	}
+
+	auto sectionText = this->findSectionText(name, true);
+	if (sectionText == nullptr)
+		return;
+
+	// Only parse the children's start tags for now. The
+	// children's text remains valid for as long as this
+	// scene description exists.
+	XMLElementText child;
+	XMLElementScanner scanner(*sectionText);
+	while (scanner.next(child))
+	{
+		tinyxml2::XMLDocument tagDoc;
+		auto tag = child.getStartTagAsEmptyElement();
+		tagDoc.Parse(tag.c_str(), tag.size());
+		if (tagDoc.Error())
+		{
+			throw XMLParseException(tagDoc);
+		}
+
+		action(tagDoc.RootElement(), [child]()
+		{
+			auto childDoc = child.parse();
+			auto node = childDoc->RootElement();
+			return SceneSection { std::move(childDoc), node };
+		});
+	}
 }
 
-/// Parses the scene description XML document at the
-/// given path, and returns a unique pointer
-/// to the scene it describes. An exception is
+/// Parses the scene description XML document or
+/// compiled scene at the given path, and returns a unique
+/// pointer to the scene it describes. An exception is
 /// thrown is something goes wrong.
-std::unique_ptr<Scene> si::parser::parseScene(const std::string& path)
+std::unique_ptr<Scene> si::parser::parseScene(
+	const std::string& path,
+	const LoadProgressCallback& progress)
 {
 	SceneDescription description(path);
-	return description.readScene();
+	return description.readScene(progress);
 }
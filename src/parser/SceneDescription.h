@@ -1,15 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <exception>
-#include <map>
+#include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
 #include "tinyxml2/tinyxml2.h"
 #include "Common.h"
+#include "model/CollisionLayers.h"
 #include "model/Entity.h"
 #include "model/PhysicsEntity.h"
 #include "model/ShipEntity.h"
@@ -20,8 +24,14 @@
 #include "timeline/ITimelineEvent.h"
 #include "timeline/Timeline.h"
 #include "timeline/ConcurrentEvent.h"
+#include "FlagSet.h"
+#include "KeyBindings.h"
 #include "Scene.h"
 #include "ParsedEntity.h"
+#include "AssetLoader.h"
+#include "LazyAsset.h"
+#include "SoundDecoder.h"
+#include "XMLElementScanner.h"
 
 namespace si
 {
@@ -81,77 +91,152 @@ namespace si
 		/// external resources for scenes.
 		struct SceneResources
 		{
-			/// The scene's texture map.
-			std::map<std::string, std::shared_ptr<sf::Texture>> textures;
+			/// The scene's texture map. Textures are only loaded
+			/// once they are used by a renderable.
+			std::unordered_map<std::string, LazyAsset<std::shared_ptr<sf::Texture>>> textures;
 			/// The scene's font map.
-			std::map<std::string, sf::Font> fonts;
+			std::unordered_map<std::string, std::shared_ptr<sf::Font>> fonts;
 			/// The scene's sound map.
-			std::map<std::string, std::shared_ptr<sf::SoundBuffer>> sounds;
+			std::unordered_map<std::string, SoundAsset> sounds;
 			/// The scene's music map.
-			std::map<std::string, std::shared_ptr<sf::Music>> music;
+			std::unordered_map<std::string, std::shared_ptr<sf::Music>> music;
 		};
 
 		/// Defines a data structure that contains
 		/// processed resources for scenes.
 		struct SceneAssets
 		{
-			/// The scene's renderable map.
-			std::map<std::string, Factory<si::view::IRenderable_ptr>> renderables;
+			/// The scene's renderable map. Renderable factories
+			/// are only created once they are referenced.
+			std::unordered_map<std::string, LazyAsset<Factory<si::view::IRenderable_ptr>>> renderables;
 			/// The scene's sound map.
-			std::map<std::string, std::shared_ptr<sf::SoundBuffer>> sounds;
+			std::unordered_map<std::string, SoundAsset> sounds;
 			/// The scene's music map.
-			std::map<std::string, std::shared_ptr<sf::Music>> music;
+			std::unordered_map<std::string, std::shared_ptr<sf::Music>> music;
+			/// The scene's flag set, in which flag names
+			/// are interned.
+			si::FlagSet& flags;
+			/// The scene's collision layer set, in which
+			/// collision layer names are interned.
+			si::model::CollisionLayerSet& collisionLayers;
+			/// Tells if the assets that are referenced are
+			/// needed before the scene can start. Assets that
+			/// are first referenced by later timeline events
+			/// are loaded while the scene is running.
+			bool isCritical;
+		};
+
+		/// A top-level section of a scene description document.
+		/// Sections of streamed scene descriptions own the
+		/// document that they were parsed into, which is freed
+		/// along with the section.
+		struct SceneSection
+		{
+			std::unique_ptr<tinyxml2::XMLDocument> doc;
+			const tinyxml2::XMLElement* node;
 		};
 
 		/// Defines a scene description class.
+		///
+		/// Large scene description documents are streamed: only
+		/// the boundaries of their top-level sections are found up
+		/// front, and every section is parsed when it is needed.
+		/// The children of list-like sections, such as the timeline,
+		/// are parsed and processed one at a time, so a document's
+		/// complete DOM tree is never held in memory.
 		class SceneDescription final
 		{
 		public:
 			/// Creates a new scene description from the
-			/// XML document at the given path.
+			/// XML document or compiled scene at the given path.
 			SceneDescription(const std::string& path);
 
 			/// Gets the path of the XML document
 			/// that describes this scene.
 			std::string getPath() const;
 
+			/// Writes this scene description to the given
+			/// path as a compiled scene, which can be loaded
+			/// without parsing any XML.
+			void compile(const std::string& outputPath) const;
+
+			/// Gets the paths of all asset files that this
+			/// scene description refers to.
+			std::vector<std::string> getAssetPaths() const;
+
+			/// Tries to read the seed for the random generator that
+			/// this scene description specifies. A boolean is returned
+			/// that tells if the scene description specifies a seed.
+			bool tryGetSeed(std::uint32_t& result) const;
+
 			/// Reads all texture assets defined in this
-			/// scene description document.
-			std::map<std::string, std::shared_ptr<sf::Texture>> readTextures() const;
+			/// scene description document. Textures are
+			/// decoded asynchronously by the given asset loader,
+			/// once they are first used. Prewarmed textures
+			/// are requested right away. The textures' lazy
+			/// handles share ownership of the loader.
+			std::unordered_map<std::string, LazyAsset<std::shared_ptr<sf::Texture>>> readTextures(
+				const std::shared_ptr<AssetLoader>& loader) const;
 
 			/// Reads all font assets defined in this
-			/// scene description document.
-			std::map<std::string, sf::Font> readFonts() const;
+			/// scene description document. Fonts are
+			/// shared through the asset cache.
+			std::unordered_map<std::string, std::shared_ptr<sf::Font>> readFonts() const;
 
 			/// Reads all sound assets defined in this
-			/// scene description document.
-			std::map<std::string, std::shared_ptr<sf::SoundBuffer>> readSounds() const;
+			/// scene description document. Sounds are
+			/// decoded asynchronously by the given asset loader,
+			/// unless they are decoded on demand.
+			std::unordered_map<std::string, SoundAsset> readSounds(AssetLoader& loader) const;
 
 			/// Reads all music assets defined in this scene
-			/// description document.
-			std::map<std::string, std::shared_ptr<sf::Music>> readMusic() const;
+			/// description document. Music files are read
+			/// through the asset cache.
+			std::unordered_map<std::string, std::shared_ptr<sf::Music>> readMusic() const;
 
 			/// Reads all resources defined in this
-			/// scene description document.
-			SceneResources readResources() const;
+			/// scene description document. Textures and
+			/// sounds are decoded asynchronously by the
+			/// given asset loader.
+			SceneResources readResources(const std::shared_ptr<AssetLoader>& loader) const;
+
+			/// Reads the key bindings that this scene description
+			/// document defines in its (optional) controls section.
+			/// The default key bindings are returned if there is
+			/// no such section.
+			KeyBindings readKeyBindings() const;
 
 			/// Reads all renderable elements definitions in this
-			/// scene description document.
-			std::map<std::string, Factory<si::view::IRenderable_ptr>> readRenderables(
-				const SceneResources& resources) const;
+			/// scene description document. Renderable factories
+			/// are created when they are first referenced, except
+			/// for prewarmed renderables, which are created right
+			/// away. The lazy factories share ownership of the
+			/// given resources, but this scene description must
+			/// outlive them.
+			std::unordered_map<std::string, LazyAsset<Factory<si::view::IRenderable_ptr>>> readRenderables(
+				const std::shared_ptr<const SceneResources>& resources) const;
 
 			/// Reads the scene described by this document.
-			std::unique_ptr<Scene> readScene() const;
+			/// The given callback, if any, is notified
+			/// as assets are loaded. Non-critical assets may
+			/// still be loading when the scene is returned.
+			std::unique_ptr<Scene> readScene(const LoadProgressCallback& progress = nullptr) const;
 
 			/// Reads a renderable group element specified by the given node.
+			/// The given flag tells if the group's textures are needed
+			/// before the scene can start.
 			static Factory<si::view::IRenderable_ptr> readGroupRenderable(
 				const tinyxml2::XMLElement* node,
-				const SceneResources& resources);
+				const SceneResources& resources,
+				bool isCritical);
 
 			/// Reads a renderable element specified by the given node.
+			/// The given flag tells if the renderable's textures are
+			/// needed before the scene can start.
 			static Factory<si::view::IRenderable_ptr> readRenderable(
 				const tinyxml2::XMLElement* node,
-				const SceneResources& resources);
+				const SceneResources& resources,
+				bool isCritical);
 
 			/// Reads an entity node's associated view.
 			static Factory<si::view::IRenderable_ptr> readAssociatedView(
@@ -274,11 +359,43 @@ namespace si
 			}
 
 		private:
-			/// Gets this scene description's texture definitions node.
-			const tinyxml2::XMLElement* getTexturesNode() const;
-
-			/// Gets this scene description's renderable definitions node.
-			const tinyxml2::XMLElement* getRenderablesNode() const;
+			/// Reads the scene description document's text, and finds
+			/// its top-level sections. Only the root element's start
+			/// tag is parsed.
+			void readSections();
+
+			/// Finds the text of the top-level section with the given
+			/// name in a streamed scene description. If the section is
+			/// optional, and it does not exist, then null is returned.
+			const XMLElementText* findSectionText(const char* name, bool isOptional) const;
+
+			/// Gets the top-level section with the given name. If the
+			/// section is optional, and it does not exist, then the
+			/// section's node is null.
+			SceneSection getSection(const char* name, bool isOptional = true) const;
+
+			/// Calls the given function for every child element of the
+			/// (optional) top-level section with the given name. A
+			/// boolean is returned that tells if the section exists.
+			bool forEachSectionChild(
+				const char* name,
+				const std::function<void(const tinyxml2::XMLElement*)>& action) const;
+
+			/// Calls the given function for every child element of the
+			/// (optional) top-level section with the given name. The
+			/// function is given an element that has the child's name and
+			/// attributes, but not necessarily its children, as well as a
+			/// function that reads the complete child element. The latter
+			/// may be called for as long as this scene description exists.
+			void forEachDeferredSectionChild(
+				const char* name,
+				const std::function<void(
+					const tinyxml2::XMLElement*,
+					const std::function<SceneSection()>&)>& action) const;
+
+			/// Creates a timeline that runs the events created by
+			/// the given factories in sequence.
+			static EventFactory createTimeline(const std::vector<EventFactory>& events);
 
 			/// Reads an on-enter controller. Its contains-model condition can be
 			/// negated, which enables this function to create on-leave controllers
@@ -347,9 +464,27 @@ namespace si
 			/// an exception is thrown.
 			static bool getBooleanAttribute(const tinyxml2::XMLElement* node, const char* name);
 
-			/// Reads the given node's physics properties.
+			/// Gets the value of the boolean attribute with the given
+			/// name in the given XML node.
+			/// If no such attribute can be found, the given default
+			/// value is returned as a result.
+			static bool getBooleanAttribute(const tinyxml2::XMLElement* node, const char* name, bool defaultValue);
+
+			/// Reads the given node's physics properties. Collision
+			/// layer names are interned in the assets' collision
+			/// layer set.
 			static si::model::PhysicsProperties getPhysicsProperties(
-				const tinyxml2::XMLElement* node);
+				const tinyxml2::XMLElement* node,
+				const SceneAssets& assets);
+
+			/// Reads the collision layers that are listed by the
+			/// given attribute of the given node, separated by spaces.
+			/// If the node has no such attribute, then the given
+			/// default value is returned.
+			static si::model::CollisionMask getCollisionMaskAttribute(
+				const tinyxml2::XMLElement* node, const char* name,
+				si::model::CollisionLayerSet& layers,
+				si::model::CollisionMask defaultValue);
 
 			/// Gets the only child of the given XML node, optionally
 			/// with the given name.
@@ -367,16 +502,40 @@ namespace si
 			static T getReferenceAttribute(
 				const tinyxml2::XMLElement* node,
 				const char* attributeName,
-				const std::map<std::string, T>& map);
+				const std::unordered_map<std::string, T>& map);
+
+			/// Gets the value of a lazy asset from the given key-value
+			/// map identified by the attribute with the given name in
+			/// the given node. The asset is created if this has not
+			/// been done yet.
+			/// If something goes wrong, an exception is thrown.
+			template<typename T>
+			static T getReferenceAttribute(
+				const tinyxml2::XMLElement* node,
+				const char* attributeName,
+				const std::unordered_map<std::string, LazyAsset<T>>& map,
+				bool isCritical);
 
 			tinyxml2::XMLDocument doc;
 			std::string path;
+
+			/// Tells if this scene description is streamed. If so,
+			/// then `doc` only contains the root element, without
+			/// any children. The document's text is kept, and its
+			/// top-level sections are parsed when they are needed.
+			bool isStreaming;
+			std::string text;
+			std::unordered_map<std::string, XMLElementText> sections;
+			std::unordered_set<std::string> duplicateSections;
 		};
 
-		/// Parses the scene description XML document at the
-		/// given path, and returns a unique pointer
-		/// to the scene it describes. An exception is
-		/// thrown is something goes wrong.
-		std::unique_ptr<Scene> parseScene(const std::string& path);
+		/// Parses the scene description XML document or
+		/// compiled scene at the given path, and returns a unique
+		/// pointer to the scene it describes. An exception is
+		/// thrown is something goes wrong. The given callback,
+		/// if any, is notified as assets are loaded.
+		std::unique_ptr<Scene> parseScene(
+			const std::string& path,
+			const LoadProgressCallback& progress = nullptr);
 	}
 }
@@ -0,0 +1,232 @@
+#include "SoundDecoder.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Audio.hpp>
+
+using namespace si;
+using namespace si::parser;
+
+/// Creates a sound asset from the given sound buffer,
+/// which holds a sound of the given length.
+SoundAsset::SoundAsset(const std::shared_ptr<sf::SoundBuffer>& buffer, sf::Time duration)
+	: buffer(buffer), encoded(), duration(duration)
+{ }
+
+/// Creates a sound asset from the given encoded sound,
+/// which is decoded on demand.
+SoundAsset::SoundAsset(const std::shared_ptr<const EncodedSound>& encoded)
+	: buffer(), encoded(encoded), duration(encoded->duration)
+{ }
+
+/// Tries to get this sound asset's sound buffer.
+std::shared_ptr<sf::SoundBuffer> SoundAsset::tryGetBuffer() const
+{
+	if (this->encoded == nullptr)
+		return this->buffer;
+	else
+		return SoundDecoder::instance().tryGetBuffer(this->encoded);
+}
+
+/// Gets the length of this sound asset's sound.
+sf::Time SoundAsset::getDuration() const
+{
+	return this->duration;
+}
+
+/// Tests if this sound asset is decoded on demand.
+bool SoundAsset::isOnDemand() const
+{
+	return this->encoded != nullptr;
+}
+
+const std::size_t SoundDecoder::DefaultMemoryBudget = 8 * 1024 * 1024;
+
+SoundDecoder::SoundDecoder()
+	: entries(), useOrder(), memoryBudget(DefaultMemoryBudget), memoryUsage(0),
+	  worker(), mutex(), jobQueued(), jobQueue(), decodedJobs(), isStopping(false)
+{ }
+
+/// Stops the decoder's background thread.
+SoundDecoder::~SoundDecoder()
+{
+	if (!this->worker.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->isStopping = true;
+	}
+	this->jobQueued.notify_all();
+	this->worker.join();
+}
+
+/// Gets the one and only sound decoder.
+SoundDecoder& SoundDecoder::instance()
+{
+	// Like the asset cache, the decoder is a function-local
+	// static, because it owns SFML resources.
+	static SoundDecoder result;
+	return result;
+}
+
+/// Tries to get the decoded version of the given encoded
+/// sound, and marks it as recently played.
+std::shared_ptr<sf::SoundBuffer> SoundDecoder::tryGetBuffer(const std::shared_ptr<const EncodedSound>& sound)
+{
+	this->poll();
+
+	auto pos = this->entries.find(sound.get());
+	if (pos != this->entries.end())
+	{
+		auto& entry = pos->second;
+		this->useOrder.splice(this->useOrder.begin(), this->useOrder, entry.usePosition);
+		return entry.buffer;
+	}
+
+	// The sound is not in the cache. Queue it for decoding.
+	this->useOrder.push_front(sound.get());
+	this->entries[sound.get()] = CacheEntry { sound, nullptr, 0, this->useOrder.begin() };
+
+	auto job = std::make_shared<DecodeJob>();
+	job->sound = sound;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->jobQueue.push_back(job);
+	}
+	this->jobQueued.notify_one();
+
+	if (!this->worker.joinable())
+		this->worker = std::thread([this]() { this->runWorker(); });
+
+	return nullptr;
+}
+
+/// Creates sound buffers for all sounds that have been
+/// decoded, and then evicts sounds if the cache exceeds
+/// its memory budget.
+void SoundDecoder::poll()
+{
+	std::vector<std::shared_ptr<DecodeJob>> ready;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (this->decodedJobs.empty())
+			return;
+
+		ready.swap(this->decodedJobs);
+	}
+
+	for (const auto& job : ready)
+	{
+		auto& entry = this->entries.at(job->sound.get());
+		entry.buffer = std::make_shared<sf::SoundBuffer>();
+		if (job->isDecoded && entry.buffer->loadFromSamples(
+			job->samples.data(), job->samples.size(), job->channelCount, job->sampleRate))
+		{
+			entry.byteSize = job->samples.size() * sizeof(sf::Int16);
+			this->memoryUsage += entry.byteSize;
+		}
+
+		// The sound was decoded because it is about to be
+		// played, so make sure that it isn't evicted before
+		// that happens.
+		this->useOrder.splice(this->useOrder.begin(), this->useOrder, entry.usePosition);
+		this->trim();
+	}
+}
+
+/// Gets the number of bytes that decoded sounds may use
+/// before they are evicted.
+std::size_t SoundDecoder::getMemoryBudget() const
+{
+	return this->memoryBudget;
+}
+
+/// Sets the number of bytes that decoded sounds may use
+/// before they are evicted.
+void SoundDecoder::setMemoryBudget(std::size_t budget)
+{
+	this->memoryBudget = budget;
+	this->trim();
+}
+
+/// Gets the number of bytes that decoded sounds use.
+std::size_t SoundDecoder::getMemoryUsage() const
+{
+	return this->memoryUsage;
+}
+
+/// Takes jobs from the job queue and decodes them,
+/// until the sound decoder is stopped.
+void SoundDecoder::runWorker()
+{
+	while (true)
+	{
+		std::shared_ptr<DecodeJob> job;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->jobQueued.wait(lock, [this]()
+			{
+				return this->isStopping || !this->jobQueue.empty();
+			});
+
+			if (this->isStopping)
+				return;
+
+			job = this->jobQueue.front();
+			this->jobQueue.pop_front();
+		}
+
+		// SFML's sound file readers have been registered by
+		// now: encoded sounds are opened once on the main
+		// thread when they are read.
+		const auto& contents = *job->sound->contents;
+		sf::InputSoundFile file;
+		job->isDecoded = file.openFromMemory(contents.data(), contents.size());
+		if (job->isDecoded)
+		{
+			job->samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+			auto readCount = file.read(job->samples.data(), job->samples.size());
+			job->samples.resize(static_cast<std::size_t>(readCount));
+			job->channelCount = file.getChannelCount();
+			job->sampleRate = file.getSampleRate();
+		}
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->decodedJobs.push_back(job);
+	}
+}
+
+/// Evicts decoded sounds, in least-recently-played order,
+/// until the cache fits in its memory budget.
+void SoundDecoder::trim()
+{
+	auto pos = this->useOrder.end();
+	while (this->memoryUsage > this->memoryBudget && pos != this->useOrder.begin())
+	{
+		--pos;
+		if (pos == this->useOrder.begin())
+			// Never evict the most recently played sound.
+			break;
+
+		auto entryPos = this->entries.find(*pos);
+		// Sounds that are still being decoded are left alone.
+		if (entryPos->second.buffer != nullptr)
+		{
+			// Voices that are playing the sound keep its
+			// buffer alive until they are done with it.
+			this->memoryUsage -= entryPos->second.byteSize;
+			++pos;
+			this->useOrder.erase(entryPos->second.usePosition);
+			this->entries.erase(entryPos);
+		}
+	}
+}
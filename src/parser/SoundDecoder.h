@@ -0,0 +1,173 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Audio.hpp>
+
+namespace si
+{
+	namespace parser
+	{
+		/// Describes a sound that is kept in memory in encoded
+		/// form, i.e., as the contents of an OGG, FLAC or WAV file.
+		struct EncodedSound
+		{
+			/// The path of the file that the sound was read from.
+			std::string path;
+			/// The file's contents.
+			std::shared_ptr<const std::vector<char>> contents;
+			/// The length of the sound, which is read from the
+			/// file's header, so it is known before the sound
+			/// is decoded.
+			sf::Time duration;
+		};
+
+		/// Defines a sound asset: a sound that can be played. A sound
+		/// asset either wraps a sound buffer that was decoded up front,
+		/// or an encoded sound that is decoded when it is played.
+		class SoundAsset final
+		{
+		public:
+			/// Creates a sound asset from the given sound buffer,
+			/// which holds a sound of the given length. The buffer
+			/// may still be empty, if it is being loaded.
+			SoundAsset(const std::shared_ptr<sf::SoundBuffer>& buffer, sf::Time duration);
+
+			/// Creates a sound asset from the given encoded sound,
+			/// which is decoded on demand.
+			SoundAsset(const std::shared_ptr<const EncodedSound>& encoded);
+
+			/// Tries to get this sound asset's sound buffer. If this
+			/// sound asset is encoded, and it has not been decoded yet,
+			/// then it is queued for decoding, and null is returned.
+			std::shared_ptr<sf::SoundBuffer> tryGetBuffer() const;
+
+			/// Gets the length of this sound asset's sound. The
+			/// length is known even if the sound has not been
+			/// loaded or decoded yet.
+			sf::Time getDuration() const;
+
+			/// Tests if this sound asset is decoded on demand.
+			bool isOnDemand() const;
+
+		private:
+			std::shared_ptr<sf::SoundBuffer> buffer;
+			std::shared_ptr<const EncodedSound> encoded;
+			sf::Time duration;
+		};
+
+		/// Defines a sound decoder, which decodes encoded sounds on
+		/// a background thread. Decoded sounds are kept in a cache,
+		/// from which the least recently played sounds are evicted
+		/// once the cache exceeds its memory budget. Only the sounds
+		/// that are played often stay decoded.
+		///
+		/// Sound buffers are created on the thread that uses the
+		/// sound decoder, which should be the thread that plays
+		/// the game's sounds. The decoder is not thread-safe.
+		class SoundDecoder final
+		{
+		public:
+			SoundDecoder(const SoundDecoder&) = delete;
+
+			/// Stops the decoder's background thread.
+			~SoundDecoder();
+
+			/// Gets the one and only sound decoder.
+			static SoundDecoder& instance();
+
+			/// Tries to get the decoded version of the given encoded
+			/// sound, and marks it as recently played. If the sound has
+			/// not been decoded yet, then it is queued for decoding,
+			/// and null is returned. A sound that cannot be decoded
+			/// is decoded as silence.
+			std::shared_ptr<sf::SoundBuffer> tryGetBuffer(const std::shared_ptr<const EncodedSound>& sound);
+
+			/// Creates sound buffers for all sounds that have been
+			/// decoded, and then evicts sounds if the cache exceeds
+			/// its memory budget.
+			void poll();
+
+			/// Gets the number of bytes that decoded sounds may use
+			/// before they are evicted.
+			std::size_t getMemoryBudget() const;
+
+			/// Sets the number of bytes that decoded sounds may use
+			/// before they are evicted.
+			void setMemoryBudget(std::size_t budget);
+
+			/// Gets the number of bytes that decoded sounds use.
+			std::size_t getMemoryUsage() const;
+
+			/// The default number of bytes that decoded sounds
+			/// may use before they are evicted.
+			static const std::size_t DefaultMemoryBudget;
+
+		private:
+			SoundDecoder();
+
+			/// Describes a sound that is waiting to be decoded,
+			/// or that has just been decoded.
+			struct DecodeJob
+			{
+				std::shared_ptr<const EncodedSound> sound;
+
+				/// The decoded sound's samples.
+				std::vector<sf::Int16> samples;
+				unsigned int channelCount;
+				unsigned int sampleRate;
+
+				/// Tells if the sound was decoded successfully.
+				bool isDecoded;
+			};
+
+			/// Describes a sound in the cache.
+			struct CacheEntry
+			{
+				/// The cache entry keeps the encoded sound alive, so
+				/// its address is not reused while it is in the cache.
+				std::shared_ptr<const EncodedSound> sound;
+				/// The decoded sound, or null if the sound is
+				/// still being decoded.
+				std::shared_ptr<sf::SoundBuffer> buffer;
+				std::size_t byteSize;
+				/// The entry's position in the recently-played list.
+				std::list<const EncodedSound*>::iterator usePosition;
+			};
+
+			/// Takes jobs from the job queue and decodes them,
+			/// until the sound decoder is stopped.
+			void runWorker();
+
+			/// Evicts decoded sounds, in least-recently-played order,
+			/// until the cache fits in its memory budget. The most
+			/// recently played sound is never evicted.
+			void trim();
+
+			std::unordered_map<const EncodedSound*, CacheEntry> entries;
+			std::list<const EncodedSound*> useOrder;
+			std::size_t memoryBudget;
+			std::size_t memoryUsage;
+
+			/// The background thread, which is started when the
+			/// first sound is queued.
+			std::thread worker;
+
+			/// Guards the job queue, the decoded list and the
+			/// stop flag.
+			std::mutex mutex;
+			std::condition_variable jobQueued;
+			std::deque<std::shared_ptr<DecodeJob>> jobQueue;
+			std::vector<std::shared_ptr<DecodeJob>> decodedJobs;
+			bool isStopping;
+		};
+	}
+}
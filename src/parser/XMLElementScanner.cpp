@@ -0,0 +1,196 @@
+#include "XMLElementScanner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "tinyxml2/tinyxml2.h"
+#include "SceneDescription.h"
+
+using namespace si;
+using namespace si::parser;
+
+/// Tests if this element is an empty element,
+/// i.e., if it does not have an end tag.
+bool XMLElementText::isEmptyElement() const
+{
+	return this->contentBegin == this->end;
+}
+
+/// Gets the text of this element's start tag, as
+/// an empty element tag.
+std::string XMLElementText::getStartTagAsEmptyElement() const
+{
+	if (this->isEmptyElement())
+		return std::string(this->begin, this->end);
+
+	// Replace the start tag's '>' by '/>'.
+	return std::string(this->begin, this->contentBegin - 1) + "/>";
+}
+
+/// Parses this element's text as an XML document.
+std::unique_ptr<tinyxml2::XMLDocument> XMLElementText::parse() const
+{
+	auto result = std::make_unique<tinyxml2::XMLDocument>();
+	result->Parse(this->begin, this->end - this->begin);
+	if (result->Error())
+	{
+		throw XMLParseException(*result);
+	}
+	return result;
+}
+
+/// Creates an XML element scanner for the given text.
+XMLElementScanner::XMLElementScanner(const char* begin, const char* end)
+	: position(begin), end(end)
+{ }
+
+/// Creates an XML element scanner for the given
+/// element's content.
+XMLElementScanner::XMLElementScanner(const XMLElementText& parent)
+	: position(parent.contentBegin), end(parent.contentEnd)
+{ }
+
+/// Finds the next element, and stores its boundaries
+/// in the given result.
+bool XMLElementScanner::next(XMLElementText& result)
+{
+	while (true)
+	{
+		// Skip text.
+		this->position = std::find(this->position, this->end, '<');
+		if (this->position == this->end)
+			return false;
+
+		if (this->startsWith("<!--"))
+			this->skipPast("-->");
+		else if (this->startsWith("<![CDATA["))
+			this->skipPast("]]>");
+		else if (this->startsWith("<?"))
+			this->skipPast("?>");
+		else if (this->startsWith("<!"))
+			this->skipPast(">");
+		else if (this->startsWith("</"))
+			throw XMLParseException("XML_ERROR_MISMATCHED_ELEMENT", "Unexpected end tag.", "");
+		else
+			break;
+	}
+
+	// We found a start tag. Read the element's name.
+	result.begin = this->position;
+	auto nameEnd = result.begin + 1;
+	while (nameEnd != this->end && std::strchr(" \t\r\n/>", *nameEnd) == nullptr)
+	{
+		nameEnd++;
+	}
+	result.name.assign(result.begin + 1, nameEnd);
+
+	bool isEmpty = this->skipTag();
+	result.contentBegin = this->position;
+	if (isEmpty)
+	{
+		result.contentEnd = this->position;
+		result.end = this->position;
+		return true;
+	}
+
+	// Find the matching end tag. Only the nesting depth
+	// is tracked: tinyxml2 checks that tag names match
+	// when the element is parsed.
+	int depth = 1;
+	while (true)
+	{
+		this->position = std::find(this->position, this->end, '<');
+		if (this->position == this->end)
+			this->throwUnterminated(result.name);
+
+		if (this->startsWith("<!--"))
+		{
+			this->skipPast("-->");
+		}
+		else if (this->startsWith("<![CDATA["))
+		{
+			this->skipPast("]]>");
+		}
+		else if (this->startsWith("<?"))
+		{
+			this->skipPast("?>");
+		}
+		else if (this->startsWith("<!"))
+		{
+			this->skipPast(">");
+		}
+		else if (this->startsWith("</"))
+		{
+			auto endTagBegin = this->position;
+			this->skipPast(">");
+			depth--;
+			if (depth == 0)
+			{
+				result.contentEnd = endTagBegin;
+				result.end = this->position;
+				return true;
+			}
+		}
+		else if (!this->skipTag())
+		{
+			depth++;
+		}
+	}
+}
+
+/// Skips the markup that starts at the current
+/// position and ends with the given terminator.
+void XMLElementScanner::skipPast(const char* terminator)
+{
+	auto terminatorEnd = terminator + std::strlen(terminator);
+	auto pos = std::search(this->position, this->end, terminator, terminatorEnd);
+	if (pos == this->end)
+	{
+		throw XMLParseException(
+			"XML_ERROR_PARSING", "Unterminated markup; expected '" + std::string(terminator) + "'.", "");
+	}
+	this->position = pos + (terminatorEnd - terminator);
+}
+
+/// Skips the tag that starts at the current position.
+bool XMLElementScanner::skipTag()
+{
+	char previous = '\0';
+	for (this->position++; this->position != this->end; this->position++)
+	{
+		char c = *this->position;
+		if (c == '"' || c == '\'')
+		{
+			// Skip quoted attribute values, which may
+			// contain '>' characters.
+			this->position = std::find(this->position + 1, this->end, c);
+			if (this->position == this->end)
+				break;
+		}
+		else if (c == '>')
+		{
+			this->position++;
+			return previous == '/';
+		}
+		previous = c;
+	}
+
+	throw XMLParseException("XML_ERROR_PARSING_ELEMENT", "Unterminated tag.", "");
+}
+
+/// Tests if the text at the current position starts
+/// with the given prefix.
+bool XMLElementScanner::startsWith(const char* prefix) const
+{
+	auto length = std::strlen(prefix);
+	return static_cast<std::size_t>(this->end - this->position) >= length
+		&& std::memcmp(this->position, prefix, length) == 0;
+}
+
+/// Throws an exception that reports that the element
+/// with the given name is not terminated.
+void XMLElementScanner::throwUnterminated(const std::string& name) const
+{
+	throw XMLParseException("XML_ERROR_PARSING_ELEMENT", "Element '" + name + "' is not terminated.", "");
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "tinyxml2/tinyxml2.h"
+
+namespace si
+{
+	namespace parser
+	{
+		/// Describes the text of a single XML element.
+		struct XMLElementText
+		{
+			/// The element's name.
+			std::string name;
+			/// The start of the element's start tag.
+			const char* begin;
+			/// The end of the element's end tag.
+			const char* end;
+			/// The start of the element's content, i.e., the
+			/// text between its start and end tags. For empty
+			/// elements, this is the end of the element.
+			const char* contentBegin;
+			/// The end of the element's content.
+			const char* contentEnd;
+
+			/// Tests if this element is an empty element,
+			/// i.e., if it does not have an end tag.
+			bool isEmptyElement() const;
+
+			/// Gets the text of this element's start tag, as
+			/// an empty element tag. The resulting element
+			/// has this element's attributes, but no children.
+			std::string getStartTagAsEmptyElement() const;
+
+			/// Parses this element's text as an XML document.
+			/// An XMLParseException is thrown if the text is
+			/// not well-formed.
+			std::unique_ptr<tinyxml2::XMLDocument> parse() const;
+		};
+
+		/// Defines an XML element scanner, which finds the
+		/// boundaries of the elements in a piece of XML text,
+		/// without parsing the elements themselves.
+		///
+		/// This allows large documents to be parsed one element
+		/// at a time: only the element that is being processed
+		/// needs to be kept in memory as a DOM tree.
+		class XMLElementScanner final
+		{
+		public:
+			/// Creates an XML element scanner for the given text.
+			XMLElementScanner(const char* begin, const char* end);
+
+			/// Creates an XML element scanner for the given
+			/// element's content.
+			XMLElementScanner(const XMLElementText& parent);
+
+			/// Finds the next element, and stores its boundaries
+			/// in the given result. Text, comments, processing
+			/// instructions and declarations in between elements
+			/// are skipped. A boolean is returned that tells if
+			/// an element was found. An XMLParseException is thrown
+			/// if an element is not terminated.
+			bool next(XMLElementText& result);
+
+		private:
+			/// Skips the markup that starts at the current
+			/// position and ends with the given terminator.
+			void skipPast(const char* terminator);
+
+			/// Skips the tag that starts at the current position.
+			/// A boolean is returned that tells if the tag is an
+			/// empty element tag.
+			bool skipTag();
+
+			/// Tests if the text at the current position starts
+			/// with the given prefix.
+			bool startsWith(const char* prefix) const;
+
+			/// Throws an exception that reports that the element
+			/// with the given name is not terminated.
+			[[noreturn]] void throwUnterminated(const std::string& name) const;
+
+			const char* position;
+			const char* end;
+		};
+	}
+}
@@ -1,7 +1,9 @@
 #include "ConditionalEvent.h"
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include "FlagSet.h"
 #include "ITimelineEvent.h"
 #include "Scene.h"
 
@@ -19,6 +21,22 @@ ConditionalEvent::ConditionalEvent(
 	: condition(condition), ifEvent(ifEvent), 
 	  elseEvent(elseEvent), 
 	  shouldReevaluate(shouldReevaluate), 
+	  isFlagCondition(false), flag(0), flagChangeCount(0),
+	  state(NotRunning)
+{ }
+
+/// Creates a conditional event that selects its
+/// if-clause event when the flag with the given identifier
+/// is set, and its else-clause event otherwise.
+ConditionalEvent::ConditionalEvent(
+	FlagId flag,
+	const ITimelineEvent_ptr& ifEvent,
+	const ITimelineEvent_ptr& elseEvent,
+	bool shouldReevaluate)
+	: condition([=](const Scene& scene) { return scene.getFlag(flag); }),
+	  ifEvent(ifEvent), elseEvent(elseEvent),
+	  shouldReevaluate(shouldReevaluate),
+	  isFlagCondition(true), flag(flag), flagChangeCount(0),
 	  state(NotRunning)
 { }
 
@@ -32,7 +50,7 @@ void ConditionalEvent::start(Scene& target)
 /// Has this timeline event update the given scene.
 bool ConditionalEvent::update(Scene& target, duration_t timeDelta)
 {
-	if (shouldReevaluate)
+	if (shouldReevaluate && this->isConditionStale(target))
 		this->reevaluateCondition(target);
 	return this->selectedEvent()->update(target, timeDelta);
 }
@@ -59,6 +77,9 @@ bool ConditionalEvent::isRunning() const
 /// event if necessary.
 void ConditionalEvent::reevaluateCondition(Scene& target)
 {
+	if (this->isFlagCondition)
+		this->flagChangeCount = target.getFlags().getChangeCount(this->flag);
+
 	bool outcome = this->condition(target);
 	if (outcome && this->state != IfClause)
 	{
@@ -74,6 +95,16 @@ void ConditionalEvent::reevaluateCondition(Scene& target)
 	}
 }
 
+/// Checks if the condition might have changed since it
+/// was last evaluated.
+bool ConditionalEvent::isConditionStale(const Scene& target) const
+{
+	// Arbitrary predicates have to be evaluated every time,
+	// but flag conditions only change when the flag flips.
+	return !this->isFlagCondition
+		|| target.getFlags().getChangeCount(this->flag) != this->flagChangeCount;
+}
+
 /// Gets the currently selected event.
 ITimelineEvent_ptr ConditionalEvent::selectedEvent() const
 {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include "FlagSet.h"
 #include "ITimelineEvent.h"
 #include "Scene.h"
 
@@ -28,6 +30,16 @@ namespace si
 				const ITimelineEvent_ptr& elseEvent,
 				bool shouldReevaluate = true);
 
+			/// Creates a conditional event that selects its
+			/// if-clause event when the flag with the given identifier
+			/// is set, and its else-clause event otherwise.
+			/// The flag is only re-evaluated when it flips.
+			ConditionalEvent(
+				FlagId flag,
+				const ITimelineEvent_ptr& ifEvent,
+				const ITimelineEvent_ptr& elseEvent,
+				bool shouldReevaluate = true);
+
 			/// Starts the timeline event.
 			void start(Scene& target) final override;
 
@@ -58,6 +70,10 @@ namespace si
 			/// event if necessary.
 			void reevaluateCondition(Scene& target);
 
+			/// Checks if the condition might have changed since it
+			/// was last evaluated.
+			bool isConditionStale(const Scene& target) const;
+
 			/// Gets the currently selected event.
 			ITimelineEvent_ptr selectedEvent() const;
 
@@ -65,6 +81,14 @@ namespace si
 			const ITimelineEvent_ptr ifEvent;
 			const ITimelineEvent_ptr elseEvent;
 			const bool shouldReevaluate;
+
+			/// The flag that the condition depends on, if the
+			/// condition is a flag. The flag's change count is
+			/// recorded whenever the condition is evaluated.
+			const bool isFlagCondition;
+			const FlagId flag;
+			std::size_t flagChangeCount;
+
 			enum { NotRunning, IfClause, ElseClause } state;
 		};
 	}
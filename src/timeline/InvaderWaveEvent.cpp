@@ -1,14 +1,17 @@
 #include "InvaderWaveEvent.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <set>
 #include <vector>
 #include "Common.h"
 #include "model/Entity.h"
 #include "model/Game.h"
 #include "model/DriftingEntity.h"
+#include "model/PathDescriptor.h"
 #include "view/IRenderable.h"
 #include "controller/IController.h"
-#include "controller/PathController.h"
+#include "controller/FormationController.h"
 #include "controller/IntervalActionController.h"
 #include "parser/ParsedEntity.h"
 #include "ITimelineEvent.h"
@@ -29,9 +32,12 @@ InvaderWaveEvent::InvaderWaveEvent(
 	int rowCount, int columnCount, const InvaderBehavior& invaderBehavior)
 	: shipFactory(shipFactory), projectileFactory(projectileFactory),
 	  rowCount(rowCount), columnCount(columnCount),
-	  invaderBehavior(invaderBehavior), shipEvents()
+	  invaderBehavior(invaderBehavior), shipEvents(), liveShips(), frontRows(), formation(),
+	  fireDeviations(), spawnCount(0)
 { }
 
+const std::size_t InvaderWaveEvent::DefaultSpawnBudget = 8;
+
 /// Starts the timeline event.
 void InvaderWaveEvent::start(Scene& target)
 {
@@ -39,9 +45,60 @@ void InvaderWaveEvent::start(Scene& target)
 	if (shipEvents.size() > 0)
 	{
 		this->end(target);
-		this->shipEvents.clear();
 	}
 
+	// Every ship gets a slot up front. Ships that have not
+	// been spawned yet, or that have been eliminated, have
+	// a null event.
+	auto columns = static_cast<std::size_t>(std::max(this->columnCount, 0));
+	auto rows = static_cast<std::size_t>(std::max(this->rowCount, 0));
+	this->shipEvents.assign(columns * rows, nullptr);
+	this->liveShips.clear();
+	this->liveShips.reserve(columns * rows);
+	this->frontRows.assign(columns, rows);
+	this->spawnCount = 0;
+
+	// Pick every invader's fire interval deviation at once.
+	this->fireDeviations.assign(columns * rows, 0.0);
+	if (this->projectileFactory != nullptr)
+	{
+		si::RandomGenerator::instance.fillReal(
+			this->fireDeviations.data(), this->fireDeviations.size(), -1.0, 1.0);
+	}
+
+	// The formation controller is created along with the
+	// first ship, because its path depends on the ships' size.
+	this->formation = nullptr;
+
+	this->spawnPending(target);
+}
+
+/// Spawns the invaders that are next in line, without
+/// exceeding the spawn budget.
+void InvaderWaveEvent::spawnPending(Scene& target)
+{
+	auto totalCount = this->shipEvents.size();
+	if (this->spawnCount == totalCount)
+		return;
+
+	auto budget = this->invaderBehavior.spawnBudget;
+	auto endCount = budget == 0 ? totalCount : std::min(this->spawnCount + budget, totalCount);
+
+	// Ships are spawned row by row, front row first. That way,
+	// a ship never opens fire just because the ship in front
+	// of it has not been spawned yet.
+	for (; this->spawnCount < endCount; this->spawnCount++)
+	{
+		int row = static_cast<int>(this->spawnCount / this->columnCount);
+		int column = static_cast<int>(this->spawnCount % this->columnCount);
+		this->spawnShip(target, column, row);
+	}
+}
+
+/// Spawns the invader ship in the i-th column
+/// and j-th row.
+void InvaderWaveEvent::spawnShip(Scene& target, int i, int j)
+{
 	const double pi = si::view::Transformation::pi;
 
 	double velPerp = this->invaderBehavior.velocity.x;
@@ -54,157 +111,172 @@ void InvaderWaveEvent::start(Scene& target)
 
 	auto projFactory = this->projectileFactory;
 
-	// Create ships
-	for (int i = 0; i < this->columnCount; i++)
+	// Create a new ship entity.
+	auto entity = this->shipFactory();
+	auto model = entity.model;
+
+	// Now compute the entity's initial position in the game.
+	// We want to position ships like this, where the columns
+	// are placed in the middle of the screen, and the nth row
+	// is placed at the top of the screen:
+	//
+	//           | col 1 |  ...  | col n |
+	//     ------|-----------------------|
+	//     row n |       |       |       |
+	//     ------|-----------------------|
+	//     ...   |       |       |       |
+	//     ------|-----------------------|
+	//     row 1 |       |       |       |
+	//
+	// In addition, we'll also re-orient this grid to match the
+	// target direction.
+
+
+	double radius = model->getPhysicsProperties().radius;
+
+	// Make sure the invader ships are positioned at safe distances, so
+	// they don't crash into each other.
+	double spacingPerp = spacing.x;
+	double spacingDir = spacing.y;
+	double totalPerp = radius * this->columnCount + spacingPerp * (this->columnCount - 1);
+	double totalDir = radius * this->rowCount + spacingDir * (this->rowCount - 1);
+	double offsetPerp = radius * i + spacingPerp * i;
+	double offsetDir = radius * j + spacingDir * j;
+
+	double posPerp = -totalPerp / 2.0 + offsetPerp;
+	double posDir = totalDir - offsetDir;
+
+	// Now compute the actual x and y positions.
+	Vector2d pos(posDir * targetDir + posPerp * perpDir);
+	pos += this->invaderBehavior.spawnPosition;
+
+	if (this->formation == nullptr)
 	{
-		std::vector<ITimelineEvent_ptr> column;
-		for (int j = 0; j < this->rowCount; j++)
-		{
-			// Create a new ship entity.
-			auto entity = this->shipFactory();
-			auto model = entity.model;
-
-			// Now compute the entity's initial position in the game.
-			// We want to position ships like this, where the columns
-			// are placed in the middle of the screen, and the nth row
-			// is placed at the top of the screen:
-			//
-			//           | col 1 |  ...  | col n |
-			//     ------|-----------------------|
-			//     row n |       |       |       |
-			//     ------|-----------------------|
-			//     ...   |       |       |       |
-			//     ------|-----------------------|
-			//     row 1 |       |       |       |
-			//
-			// In addition, we'll also re-orient this grid to match the
-			// target direction.
-
-
-			double radius = model->getPhysicsProperties().radius;
-
-			// Make sure the invader ships are positioned at safe distances, so
-			// they don't crash into each other.
-			double spacingPerp = spacing.x;
-			double spacingDir = spacing.y;
-			double totalPerp = radius * this->columnCount + spacingPerp * (this->columnCount - 1);
-			double totalDir = radius * this->rowCount + spacingDir * (this->rowCount - 1);
-			double offsetPerp = radius * i + spacingPerp * i;
-			double offsetDir = radius * j + spacingDir * j;
-
-			double posPerp = -totalPerp / 2.0 + offsetPerp;
-			double posDir = totalDir - offsetDir;
-
-			// Now compute the actual x and y positions.
-			Vector2d pos(posDir * targetDir + posPerp * perpDir);
-			pos += this->invaderBehavior.spawnPosition;
-
-			model->setPosition(pos);
-
-			// Now sketch out a path for the ships to follow.
-			// We'll have them follow a gentle sine curve, by
-			// attaching them to a critically dampened spring
-			// controller.
-			//
-			// We'll use the Y-axis component of their
-			// velocity to determine how quickly they move
-			// toward the bottom of the screen.
-			//
-			// The X-axis component of their velocity will
-			// determine how quickly they zig-zag.
-
-
-			auto path = [=](duration_t time) -> Vector2d
-			{
-				auto perp = radius * std::sin(velPerp * pi * time.count()) * perpDir;
-				auto dir = velDir * time.count() * targetDir;
+		// Now sketch out a path for the formation to follow.
+		// We'll have it follow a gentle sine curve. Unless the
+		// formation is rigid, ships are attached to their spots
+		// by critically dampened springs.
+		//
+		// We'll use the Y-axis component of the ships'
+		// velocity to determine how quickly they move
+		// toward the bottom of the screen.
+		//
+		// The X-axis component of their velocity will
+		// determine how quickly they zig-zag.
+		auto path = si::model::PathDescriptor::weave(
+			this->invaderBehavior.spawnPosition, velDir * targetDir,
+			radius * perpDir, velPerp * pi);
 
-				return pos + perp + dir;
-			};
+		this->formation = std::make_shared<si::controller::FormationController>(
+			path, this->invaderBehavior.isRigid ? 0.0 : this->invaderBehavior.springConstant);
+		target.addController(this->formation);
+	}
 
-			// A path controller will make the invader ship trace
-			// the path function we just created.
-			auto pathController = std::make_shared<si::controller::PathController>(
-				model, this->invaderBehavior.springConstant, path);
+	// Every ship keeps its initial offset from the spawn
+	// position. Ships that are spawned late take their spot
+	// in the formation right away.
+	auto offset = pos - this->invaderBehavior.spawnPosition;
+	model->setPosition(this->formation->getPosition(offset));
+	this->formation->add(model, offset);
 
-			ITimelineEvent_ptr lifetimeEvent;
+	ITimelineEvent_ptr lifetimeEvent;
 
-			if (projFactory != nullptr)
+	if (projFactory != nullptr)
+	{
+		// Let's get the invaders to fire some projectiles
+		// at us by creating an interval action controller.
+		auto fireProjectileController = std::make_shared<si::controller::IntervalActionController>(
+			this->invaderBehavior.fireInterval +
+				this->fireDeviations[i * this->rowCount + j] * this->invaderBehavior.fireIntervalDeviation,
+			[=](const si::model::Game&, duration_t) -> bool
 			{
-				// Let's get the invaders to fire some projectiles
-				// at us by creating an interval action controller.
-				auto fireProjectileController = std::make_shared<si::controller::IntervalActionController>(
-					this->invaderBehavior.fireInterval +
-						si::RandomGenerator::instance.nextReal<double>(-1.0, 1.0) * this->invaderBehavior.fireIntervalDeviation,
-					[=](const si::model::Game&, duration_t) -> bool
-					{
-						for (std::size_t k = 0; k < static_cast<std::size_t>(j); k++)
-						{
-							if (this->shipEvents.at(i).at(k) != nullptr)
-								// Don't open fire if there is another invader
-								// in front of this ship.
-								return false;
-						}
-						return true;
-					}, [=, &target](si::model::Game&, duration_t) -> void
-					{
-						si::parser::fireAndAddProjectile(*model, *projFactory, target);
-					}, [=](const si::model::Game&, duration_t) -> bool
-					{
-						return model->isAlive();
-					});
-
-				// Create an event that captures the invaders' lifetime.
-				lifetimeEvent = concurrent({
-					entity.creationEvent,
-					si::parser::createAddControllersEvent({
-						pathController,
-						fireProjectileController
-					})
-				});
-			}
-			else
+				// Don't open fire if there is another invader
+				// in front of this ship.
+				return this->frontRows[i] == static_cast<std::size_t>(j);
+			}, [=, &target](si::model::Game&, duration_t) -> void
 			{
-				// Create an event that captures the invaders' lifetime.
-				lifetimeEvent = concurrent({
-					entity.creationEvent,
-					si::parser::createAddControllersEvent({
-						pathController
-					})
-				});
-			}
-
-			// Add that event to the current column.
-			column.push_back(lifetimeEvent);
-
-			// Oh, and be sure to start that event.
-			lifetimeEvent->start(target);
+				si::parser::fireAndAddProjectile(*model, *projFactory, target);
+			}, [=](const si::model::Game&, duration_t) -> bool
+			{
+				return model->isAlive();
+			});
+
+		// Create an event that captures the invaders' lifetime.
+		lifetimeEvent = concurrent({
+			entity.creationEvent,
+			si::parser::createAddControllersEvent(model, {
+				fireProjectileController
+			})
+		});
+	}
+	else
+	{
+		// Create an event that captures the invaders' lifetime.
+		lifetimeEvent = entity.creationEvent;
+	}
+
+	// Keep track of the ship, so we know when it is eliminated.
+	auto index = static_cast<std::size_t>(i * this->rowCount + j);
+	this->shipEvents[index] = lifetimeEvent;
+	this->liveShips.push_back(index);
+	this->frontRows[i] = std::min(this->frontRows[i], static_cast<std::size_t>(j));
+
+	// Oh, and be sure to start that event.
+	lifetimeEvent->start(target);
+}
+
+/// Ends the lifetime event of the ship at the given
+/// position in the live ship list, and removes the
+/// ship from that list.
+void InvaderWaveEvent::eliminateShip(Scene& target, std::size_t liveIndex)
+{
+	auto index = this->liveShips[liveIndex];
+	this->liveShips[liveIndex] = this->liveShips.back();
+	this->liveShips.pop_back();
+
+	auto& item = this->shipEvents[index];
+	item->end(target);
+	item = nullptr;
+
+	// If the ship was at the front of its column, then the
+	// next live ship behind it moves up to the front. Every
+	// ship is passed over at most once, so this is cheap
+	// over the wave's lifetime.
+	auto rows = static_cast<std::size_t>(this->rowCount);
+	auto column = index / rows;
+	auto row = index % rows;
+	if (this->frontRows[column] == row)
+	{
+		auto& front = this->frontRows[column];
+		while (front < rows && this->shipEvents[column * rows + front] == nullptr)
+		{
+			front++;
 		}
-		this->shipEvents.push_back(column);
 	}
 }
 
 /// Has this timeline event update the given scene.
 bool InvaderWaveEvent::update(Scene& target, duration_t timeDelta)
 {
-	// Update all events. If an event has terminated,
-	// set its value to null.
-	for (auto& col : this->shipEvents)
+	// Update the lifetime events of all live ships.
+	for (std::size_t i = 0; i < this->liveShips.size();)
 	{
-		for (auto& item : col)
+		if (this->shipEvents[this->liveShips[i]]->update(target, timeDelta))
 		{
-			// Update the entity's lifetime event.
-			if (item != nullptr && !item->update(target, timeDelta))
-			{
-				// Seems like this entity is done for.
-				// End its event, and set the event pointer
-				// to null.
-				item->end(target);
-				item = nullptr;
-			}
+			i++;
+		}
+		else
+		{
+			// Seems like this entity is done for.
+			// The last live ship takes its place in
+			// the live ship list.
+			this->eliminateShip(target, i);
 		}
 	}
 
+	// Spawn the next few ships, if there are any left.
+	this->spawnPending(target);
+
 	return this->isRunning();
 }
 
@@ -213,32 +285,26 @@ bool InvaderWaveEvent::update(Scene& target, duration_t timeDelta)
 void InvaderWaveEvent::end(Scene& target)
 {
 	// Remove all ships from the scene.
-	for (auto& col : this->shipEvents)
+	while (!this->liveShips.empty())
 	{
-		for (auto& item : col)
-		{
-			if (item != nullptr)
-			{
-				// End the event.
-				item->end(target);
-				item = nullptr;
-			}
-		}
+		this->eliminateShip(target, this->liveShips.size() - 1);
 	}
+
+	// Ships that have not been spawned yet never will be.
+	this->spawnCount = this->shipEvents.size();
+
+	// Disband the formation, which will then be
+	// eliminated from the controller list.
+	if (this->formation != nullptr)
+		this->formation->disband();
 }
 
 /// Checks if this event is still running.
 bool InvaderWaveEvent::isRunning() const
 {
 	// The event is still running as long as there is
-	// at least one invader left.
-	for (const auto& col : this->shipEvents)
-	{
-		for (const auto& item : col)
-		{
-			if (item != nullptr)
-				return true;
-		}
-	}
-	return false;
+	// at least one invader left, or some invaders
+	// have yet to be spawned.
+	return !this->liveShips.empty()
+		|| this->spawnCount < this->shipEvents.size();
 }
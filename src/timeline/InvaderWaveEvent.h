@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 #include "Common.h"
 #include "model/Entity.h"
@@ -7,6 +8,7 @@
 #include "model/DriftingEntity.h"
 #include "view/IRenderable.h"
 #include "controller/IController.h"
+#include "controller/FormationController.h"
 #include "parser/ParsedEntity.h"
 #include "ITimelineEvent.h"
 #include "Scene.h"
@@ -32,6 +34,11 @@ namespace si
 			/// controller uses to trace its path.
 			double springConstant;
 
+			/// Tells if invader ships move rigidly along with
+			/// their formation, rather than being pulled toward
+			/// their spot in the formation by a spring.
+			bool isRigid;
+
 			/// The rate at which invader ships are allowed
 			/// to launch projectiles.
 			duration_t fireInterval;
@@ -54,6 +61,12 @@ namespace si
 			/// matches the target direction, and its X-component matches
 			/// the direction perpendicular to that.
 			Vector2d spacing;
+
+			/// The maximal number of invaders that are spawned
+			/// in a single frame. Large waves are spread out over
+			/// several frames, front row first. Zero means that
+			/// all invaders are spawned at once.
+			std::size_t spawnBudget;
 		};
 
 		/// Defines a type of event that spawns a wave of invaders.
@@ -97,20 +110,56 @@ namespace si
 
 			/// Checks if this event is still running.
 			bool isRunning() const;
+
+			/// The default maximal number of invaders that are
+			/// spawned in a single frame.
+			static const std::size_t DefaultSpawnBudget;
 		private:
+			/// Spawns the invaders that are next in line, without
+			/// exceeding the spawn budget.
+			void spawnPending(Scene& target);
+
+			/// Spawns the invader ship in the i-th column
+			/// and j-th row.
+			void spawnShip(Scene& target, int i, int j);
+
+			/// Ends the lifetime event of the ship at the given
+			/// position in the live ship list, and removes the
+			/// ship from that list.
+			void eliminateShip(Scene& target, std::size_t liveIndex);
+
 			const si::parser::ParsedShipFactory shipFactory;
 			const std::shared_ptr<si::parser::ParsedDriftingEntityFactory> projectileFactory;
 			const int rowCount;
 			const int columnCount;
 			const InvaderBehavior invaderBehavior;
 
-			/// Stores the wave event's ships as a vector of vectors of
-			/// timeline event pointers. Essentially, every nested vector contains
-			/// the life of all ships in a specific column - identified by the vector's
-			/// index in the topmost vector -, which can then be used to determine
-			/// which invaders are free to open fire: once an event has been ended,
-			/// its value in this vector is set to null.
-			std::vector<std::vector<ITimelineEvent_ptr>> shipEvents;
+			/// Stores the lifetime events of the wave event's ships. The
+			/// ship in the i-th column and j-th row has index
+			/// i * rowCount + j. Ships that have not been spawned yet, or
+			/// that have been eliminated, have a null event.
+			std::vector<ITimelineEvent_ptr> shipEvents;
+
+			/// The indices of the ships that are still alive, in no
+			/// particular order.
+			std::vector<std::size_t> liveShips;
+
+			/// For every column, the row of the front-most ship in that
+			/// column that is still alive, or the row count if there is
+			/// no such ship. Only the front-most ship in a column is
+			/// free to open fire.
+			std::vector<std::size_t> frontRows;
+
+			/// The formation controller that makes all of this
+			/// wave's ships follow the wave's path.
+			std::shared_ptr<si::controller::FormationController> formation;
+
+			/// The fire interval deviations of this wave's ships,
+			/// which are picked when the wave starts.
+			std::vector<double> fireDeviations;
+
+			/// The number of ships that have been spawned so far.
+			std::size_t spawnCount;
 		};
 	}
 }
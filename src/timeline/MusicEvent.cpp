@@ -11,19 +11,22 @@ using namespace si::timeline;
 
 /// Creates a music event from the given buffer.
 MusicEvent::MusicEvent(const std::shared_ptr<sf::Music>& music)
-	: music(music)
+	: music(music), elapsed(0.0)
 { }
 
 /// Starts the timeline event.
 void MusicEvent::start(Scene&)
 {
+	this->elapsed = duration_t(0.0);
 	this->music->play();
 }
 
 /// Has this timeline event update the given scene.
-bool MusicEvent::update(Scene&, duration_t)
+bool MusicEvent::update(Scene&, duration_t timeDelta)
 {
-	return this->music->getStatus() == sf::SoundSource::Playing;
+	this->elapsed += timeDelta;
+	return this->music->getLoop()
+		|| this->elapsed.count() < this->music->getDuration().asSeconds();
 }
 
 /// Applies this timeline event's finalization
@@ -11,6 +11,9 @@ namespace si
 	namespace timeline
 	{
 		/// Defines a music event: an event that plays background music.
+		/// The event lasts as long as the music, measured in simulated
+		/// time rather than by the audio device, so it ends at the same
+		/// point in every replay of a game. Looping music never ends.
 		class MusicEvent final : public ITimelineEvent
 		{
 		public:
@@ -39,6 +42,9 @@ namespace si
 			void end(Scene& target) final override;
 		private:
 			std::shared_ptr<sf::Music> music;
+			/// The amount of simulated time that has passed
+			/// since the music started playing.
+			duration_t elapsed;
 		};
 	}
 }
@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "parser/ParsedEntity.h"
 #include "view/IRenderable.h"
+#include "view/GameRenderer.h"
 #include "ITimelineEvent.h"
 #include "Scene.h"
 
@@ -12,7 +13,7 @@ using namespace si::timeline;
 /// Creates an event that adds a renderable
 /// object to the view.
 ShowEvent::ShowEvent(const si::parser::Factory<si::view::IRenderable_ptr>& factory)
-	: factory(factory), renderable(nullptr)
+	: factory(factory), renderable(nullptr), handle()
 { }
 
 /// Starts the timeline event.
@@ -24,7 +25,7 @@ void ShowEvent::start(Scene& target)
 	// Create a new renderable.
 	this->renderable = this->factory();
 	// Add the renderable to the scene.
-	target.addRenderable(this->renderable);
+	this->handle = target.addRenderable(this->renderable);
 }
 
 /// Has this timeline event update the given scene.
@@ -36,7 +37,7 @@ bool ShowEvent::update(Scene& target, duration_t)
 	if (this->renderable == nullptr)
 		return false;
 	else
-		return target.getRenderer().contains(this->renderable);
+		return target.getRenderer().contains(this->handle);
 }
 
 /// Applies this timeline event's finalization
@@ -46,7 +47,7 @@ void ShowEvent::end(Scene& target)
 	if (this->renderable != nullptr)
 	{
 		// Remove the renderable from the scene.
-		target.getRenderer().remove(this->renderable);
+		target.getRenderer().remove(this->handle);
 
 		// Set the renderable pointer to null.
 		// (We don't want to retain it forever.)
@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "parser/ParsedEntity.h"
 #include "view/IRenderable.h"
+#include "view/GameRenderer.h"
 #include "ITimelineEvent.h"
 #include "Scene.h"
 
@@ -42,6 +43,7 @@ namespace si
 		private:
 			const si::parser::Factory<si::view::IRenderable_ptr> factory;
 			si::view::IRenderable_ptr renderable;
+			si::view::RenderHandle handle;
 		};
 	}
 }
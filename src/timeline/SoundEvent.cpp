@@ -1,34 +1,67 @@
 #include "SoundEvent.h"
 
 #include <memory>
-#include <SFML/Audio/Sound.hpp>
 #include "Common.h"
 #include "ITimelineEvent.h"
+#include "VoicePool.h"
 #include "Scene.h"
+#include "parser/SoundDecoder.h"
 
 using namespace si;
 using namespace si::timeline;
 
-/// Creates a sound event from the given buffer.
-SoundEvent::SoundEvent(const std::shared_ptr<sf::SoundBuffer>& buffer)
-	: buffer(buffer), sound(*buffer)
+/// Creates a sound event from the given sound.
+SoundEvent::SoundEvent(const si::parser::SoundAsset& sound)
+	: SoundEvent(sound, SoundProperties())
+{ }
+
+/// Creates a sound event from the given sound and
+/// sound properties.
+SoundEvent::SoundEvent(
+	const si::parser::SoundAsset& sound,
+	const SoundProperties& properties)
+	: sound(sound), properties(properties), voice(),
+	  elapsed(0.0), isWaiting(false), hasVoice(false)
 { }
 
 /// Starts the timeline event.
-void SoundEvent::start(Scene&)
+void SoundEvent::start(Scene& target)
 {
-	this->sound.play();
+	this->elapsed = duration_t(0.0);
+	this->isWaiting = true;
+	this->tryPlay(target);
 }
 
 /// Has this timeline event update the given scene.
-bool SoundEvent::update(Scene&, duration_t)
+bool SoundEvent::update(Scene& target, duration_t timeDelta)
 {
-	return this->sound.getStatus() == sf::SoundSource::Playing;
+	this->elapsed += timeDelta;
+	bool isRunning = this->elapsed.count() < this->sound.getDuration().asSeconds();
+	if (this->isWaiting && isRunning)
+		this->tryPlay(target);
+
+	return isRunning;
 }
 
 /// Applies this timeline event's finalization
 /// logic to the given scene.
-void SoundEvent::end(Scene&)
+void SoundEvent::end(Scene& target)
 {
-	this->sound.stop();
+	this->isWaiting = false;
+	if (this->hasVoice)
+		target.getVoicePool().stop(this->voice);
+}
+
+/// Tries to play this event's sound, from the point
+/// that the event has reached.
+void SoundEvent::tryPlay(Scene& target)
+{
+	auto buffer = this->sound.tryGetBuffer();
+	if (buffer == nullptr)
+		return;
+
+	this->isWaiting = false;
+	this->hasVoice = target.getVoicePool().play(
+		buffer, this->properties, this->voice,
+		sf::seconds(static_cast<float>(this->elapsed.count())));
 }
@@ -1,21 +1,39 @@
 #pragma once
 
 #include <memory>
-#include <SFML/Audio/Sound.hpp>
 #include "Common.h"
 #include "ITimelineEvent.h"
+#include "VoicePool.h"
 #include "Scene.h"
+#include "parser/SoundDecoder.h"
 
 namespace si
 {
 	namespace timeline
 	{
 		/// Defines a sound event: an event that plays a sound.
+		/// Sounds are played by the scene's voice pool, which
+		/// may drop the sound, or cut it short, if too many
+		/// sounds are playing.
+		///
+		/// The event lasts as long as its sound, measured in
+		/// simulated time. Whether the sound is actually heard
+		/// does not affect the event, so it ends at the same
+		/// point in every replay of a game. Sounds that are
+		/// decoded on demand join in once they have been decoded,
+		/// at the point that the event has reached by then, so
+		/// decoding never delays the event.
 		class SoundEvent final : public ITimelineEvent
 		{
 		public:
-			/// Creates a sound event from the given buffer.
-			SoundEvent(const std::shared_ptr<sf::SoundBuffer>& buffer);
+			/// Creates a sound event from the given sound.
+			SoundEvent(const si::parser::SoundAsset& sound);
+
+			/// Creates a sound event from the given sound and
+			/// sound properties.
+			SoundEvent(
+				const si::parser::SoundAsset& sound,
+				const SoundProperties& properties);
 
 			/// Starts the sound event.
 			void start(Scene& target) final override;
@@ -38,8 +56,19 @@ namespace si
 			/// has been started.
 			void end(Scene& target) final override;
 		private:
-			std::shared_ptr<sf::SoundBuffer> buffer;
-            sf::Sound sound;
+			/// Tries to play this event's sound, from the point
+			/// that the event has reached. Nothing happens if the
+			/// sound has not been decoded yet.
+			void tryPlay(Scene& target);
+
+			si::parser::SoundAsset sound;
+			SoundProperties properties;
+			VoiceHandle voice;
+			/// The amount of simulated time that has passed
+			/// since the event was started.
+			duration_t elapsed;
+			bool isWaiting;
+			bool hasVoice;
 		};
 	}
 }
@@ -0,0 +1,183 @@
+#include "VoicePool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <SFML/Audio/Sound.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/System/Time.hpp>
+
+using namespace si;
+using namespace si::timeline;
+
+const std::size_t VoicePool::DefaultVoiceCount = 32;
+
+/// Creates a voice pool that has the given
+/// number of voices.
+VoicePool::VoicePool(std::size_t voiceCount)
+	: voices(voiceCount), playCount(0)
+{
+	for (auto& item : this->voices)
+	{
+		item.priority = 0;
+		item.startTime = 0;
+		item.generation = 0;
+	}
+}
+
+/// Plays the sound in the given buffer, with the given
+/// properties, starting at the given offset.
+bool VoicePool::play(
+	const std::shared_ptr<sf::SoundBuffer>& buffer,
+	const SoundProperties& properties,
+	VoiceHandle& result,
+	sf::Time offset)
+{
+	std::size_t index;
+	if (!this->findVoice(buffer, properties, index))
+		return false;
+
+	auto& voice = this->voices[index];
+	// Attach the voice to its new buffer before letting go
+	// of the old one. Setting the buffer also stops the
+	// voice's current sound.
+	voice.sound.setBuffer(*buffer);
+	voice.buffer = buffer;
+	voice.sound.setVolume(properties.volume);
+	voice.priority = properties.priority;
+	voice.startTime = this->playCount++;
+	voice.generation++;
+	voice.sound.play();
+	if (offset != sf::Time::Zero)
+		voice.sound.setPlayingOffset(offset);
+
+	result.voice = index;
+	result.generation = voice.generation;
+	return true;
+}
+
+/// Tests if the sound that is identified by the given
+/// handle is still playing.
+bool VoicePool::isPlaying(VoiceHandle handle) const
+{
+	return handle.voice < this->voices.size()
+		&& this->voices[handle.voice].generation == handle.generation
+		&& isBusy(this->voices[handle.voice]);
+}
+
+/// Stops the sound that is identified by the given
+/// handle, if it is still playing.
+void VoicePool::stop(VoiceHandle handle)
+{
+	if (this->isPlaying(handle))
+		this->voices[handle.voice].sound.stop();
+}
+
+/// Stops all sounds.
+void VoicePool::stopAll()
+{
+	for (auto& item : this->voices)
+	{
+		item.sound.stop();
+	}
+}
+
+/// Gets the number of voices in this pool.
+std::size_t VoicePool::getVoiceCount() const
+{
+	return this->voices.size();
+}
+
+/// Gets the number of voices that are playing
+/// a sound.
+std::size_t VoicePool::getPlayingCount() const
+{
+	std::size_t result = 0;
+	for (const auto& item : this->voices)
+	{
+		if (isBusy(item))
+			result++;
+	}
+	return result;
+}
+
+/// Tests if the given voice is playing a sound.
+bool VoicePool::isBusy(const Voice& voice)
+{
+	return voice.sound.getStatus() != sf::SoundSource::Stopped;
+}
+
+/// Tests if the first voice is a better candidate
+/// for stealing than the second voice.
+bool VoicePool::isLessImportant(const Voice& first, const Voice& second)
+{
+	if (first.priority != second.priority)
+		return first.priority < second.priority;
+
+	float firstVolume = first.sound.getVolume();
+	float secondVolume = second.sound.getVolume();
+	if (firstVolume != secondVolume)
+		return firstVolume < secondVolume;
+
+	return first.startTime < second.startTime;
+}
+
+/// Finds a voice for a sound with the given buffer and
+/// properties.
+bool VoicePool::findVoice(
+	const std::shared_ptr<sf::SoundBuffer>& buffer,
+	const SoundProperties& properties,
+	std::size_t& result) const
+{
+	std::size_t voiceCount = this->voices.size();
+
+	if (properties.maxInstances > 0)
+	{
+		// Count the instances of the buffer that are
+		// playing right now. If there are too many of them
+		// already, then one of them has to make room.
+		std::size_t instanceCount = 0;
+		std::size_t candidate = 0;
+		for (std::size_t i = 0; i < voiceCount; i++)
+		{
+			const auto& voice = this->voices[i];
+			if (voice.buffer == buffer && isBusy(voice))
+			{
+				if (instanceCount == 0 || isLessImportant(voice, this->voices[candidate]))
+					candidate = i;
+				instanceCount++;
+			}
+		}
+
+		if (instanceCount >= properties.maxInstances)
+		{
+			result = candidate;
+			return this->voices[candidate].priority <= properties.priority;
+		}
+	}
+
+	// Use an idle voice if there is one.
+	for (std::size_t i = 0; i < voiceCount; i++)
+	{
+		if (!isBusy(this->voices[i]))
+		{
+			result = i;
+			return true;
+		}
+	}
+
+	// All voices are busy. Steal the least important
+	// voice, unless it is more important than the
+	// new sound.
+	if (voiceCount == 0)
+		return false;
+
+	result = 0;
+	for (std::size_t i = 1; i < voiceCount; i++)
+	{
+		if (isLessImportant(this->voices[i], this->voices[result]))
+			result = i;
+	}
+	return this->voices[result].priority <= properties.priority;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <SFML/Audio/Sound.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/System/Time.hpp>
+
+namespace si
+{
+	namespace timeline
+	{
+		/// Defines a number of properties that tell
+		/// a voice pool how to play a sound.
+		struct SoundProperties
+		{
+			/// Creates a new set of sound properties
+			/// from the given information.
+			SoundProperties(int priority = 0, std::size_t maxInstances = 0, float volume = 100.0f)
+				: priority(priority), maxInstances(maxInstances), volume(volume)
+			{ }
+
+			/// The sound's priority. A sound can only take
+			/// over the voice of a sound whose priority is
+			/// lower than or equal to its own.
+			int priority;
+			/// The maximal number of instances of the sound's
+			/// buffer that can play at the same time, or zero
+			/// if there is no such limit.
+			std::size_t maxInstances;
+			/// The sound's volume, in the range [0, 100].
+			float volume;
+		};
+
+		/// Identifies a sound that has been played by
+		/// a voice pool.
+		struct VoiceHandle
+		{
+			/// The index of the sound's voice.
+			std::size_t voice;
+
+			/// The voice's generation at the time the sound
+			/// was played. A voice's generation is incremented
+			/// whenever it is given a new sound, which makes
+			/// handles to stolen voices harmless.
+			std::size_t generation;
+		};
+
+		/// Defines a fixed-size pool of voices, which play
+		/// sounds. Voices are created up front, and reused
+		/// after that. If all voices are busy, then the
+		/// voice that plays the least important sound is
+		/// stolen: the sound with the lowest priority, and
+		/// then the quietest and oldest one.
+		class VoicePool final
+		{
+		public:
+			/// Creates a voice pool that has the given
+			/// number of voices.
+			VoicePool(std::size_t voiceCount = DefaultVoiceCount);
+
+			VoicePool(const VoicePool&) = delete;
+
+			/// Plays the sound in the given buffer, with the given
+			/// properties, starting at the given offset. A boolean
+			/// is returned that tells if a voice was found for the
+			/// sound. If so, a handle to the sound is stored in the
+			/// given result.
+			bool play(
+				const std::shared_ptr<sf::SoundBuffer>& buffer,
+				const SoundProperties& properties,
+				VoiceHandle& result,
+				sf::Time offset = sf::Time::Zero);
+
+			/// Tests if the sound that is identified by the given
+			/// handle is still playing. Sounds whose voices have
+			/// been stolen are not playing.
+			bool isPlaying(VoiceHandle handle) const;
+
+			/// Stops the sound that is identified by the given
+			/// handle, if it is still playing.
+			void stop(VoiceHandle handle);
+
+			/// Stops all sounds.
+			void stopAll();
+
+			/// Gets the number of voices in this pool.
+			std::size_t getVoiceCount() const;
+
+			/// Gets the number of voices that are playing
+			/// a sound.
+			std::size_t getPlayingCount() const;
+
+			/// The default number of voices in a voice pool.
+			static const std::size_t DefaultVoiceCount;
+
+		private:
+			/// Describes a voice: a sound source that can
+			/// play one sound at a time.
+			struct Voice
+			{
+				/// The buffer that the voice is playing. The voice
+				/// keeps it alive for as long as it needs it.
+				std::shared_ptr<sf::SoundBuffer> buffer;
+				sf::Sound sound;
+				int priority;
+				/// The time at which the voice started playing,
+				/// as a sequence number.
+				std::uint64_t startTime;
+				std::size_t generation;
+			};
+
+			/// Tests if the given voice is playing a sound.
+			static bool isBusy(const Voice& voice);
+
+			/// Tests if the first voice is a better candidate
+			/// for stealing than the second voice.
+			static bool isLessImportant(const Voice& first, const Voice& second);
+
+			/// Finds a voice for a sound with the given buffer and
+			/// properties. A boolean is returned that tells if
+			/// such a voice was found.
+			bool findVoice(
+				const std::shared_ptr<sf::SoundBuffer>& buffer,
+				const SoundProperties& properties,
+				std::size_t& result) const;
+
+			std::vector<Voice> voices;
+			std::uint64_t playCount;
+		};
+	}
+}
@@ -16,16 +16,28 @@ AnimatedSpriteRenderable::AnimatedSpriteRenderable(
     const std::shared_ptr<sf::Texture>& texture, int frames,
     duration_t cycleDuration)
 	: SpriteRenderableBase(texture), frames(frames),
-      cycleDuration(cycleDuration), totalTime(0.0)
+      cycleDuration(cycleDuration), totalTime(0.0),
+      pendingTime(0.0), frameIndex(0)
 { }
 
 /// Gets the rectangular area of the texture to render.
-sf::IntRect AnimatedSpriteRenderable::getTextureRectangle(duration_t timeDelta)
+sf::IntRect AnimatedSpriteRenderable::getTextureRectangle(const RenderContext& context)
 {
 	auto textureSize = this->getTexture()->getSize();
+    int texX = static_cast<int>(textureSize.x);
+    int texY = static_cast<int>(textureSize.y);
+    int frameX = texX / this->frames;
+
+    // Lower quality settings update animations less often.
+    this->pendingTime += context.getTimeDelta();
+    if (this->pendingTime < context.getQuality().animationInterval)
+    {
+        return{ frameX * this->frameIndex, 0, frameX, texY };
+    }
 
     // Increment the total elapsed time.
-    this->totalTime += timeDelta;
+    this->totalTime += this->pendingTime;
+    this->pendingTime = duration_t(0.0);
 
     // Computes a floating-point number that represents the number of cycles that
     // have been completed.
@@ -42,14 +54,10 @@ sf::IntRect AnimatedSpriteRenderable::getTextureRectangle(duration_t timeDelta)
     this->totalTime -= intPart * this->cycleDuration;
 
     // Calculate the index of the current frame.
-    int frameIndex = static_cast<int>(fracPart * static_cast<double>(this->frames));
+    this->frameIndex = static_cast<int>(fracPart * static_cast<double>(this->frames));
 
     // Now we can ascertain the texture rectangle.
-    int texX = static_cast<int>(textureSize.x);
-    int texY = static_cast<int>(textureSize.y);
-
-    int frameX = texX / this->frames;
-    int offsetX = frameX * frameIndex;
+    int offsetX = frameX * this->frameIndex;
 
 	return{ offsetX, 0, frameX, texY };
 }
@@ -27,12 +27,16 @@ namespace si
 
         protected:
             /// Gets the rectangular area of the texture to render.
-            sf::IntRect getTextureRectangle(duration_t timeDelta) final override;
+            sf::IntRect getTextureRectangle(const RenderContext& context) final override;
 
 		private:
             int frames;
             duration_t cycleDuration;
 			duration_t totalTime;
+			/// The amount of time that has passed since the
+			/// current frame index was computed.
+			duration_t pendingTime;
+			int frameIndex;
 		};
 	}
 }
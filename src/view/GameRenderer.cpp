@@ -1,16 +1,136 @@
 #include "GameRenderer.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
 #include "IRenderable.h"
-#include "Container.h"
 #include "Transformation.h"
 
 using namespace si;
 using namespace si::view;
 
+const std::size_t GameRenderer::TombstoneSlot = static_cast<std::size_t>(-1);
+
 GameRenderer::GameRenderer(sf::Color backgroundColor)
-	: backgroundColor(backgroundColor)
+	: drawList(), drawListSlots(), slots(), freeSlots(),
+	  removedCount(0), backgroundColor(backgroundColor)
 { }
 
+/// Adds the given renderable to this game renderer.
+/// A handle is returned that identifies the renderable.
+RenderHandle GameRenderer::add(const IRenderable_ptr& item)
+{
+	std::size_t slot;
+	if (this->freeSlots.empty())
+	{
+		slot = this->slots.size();
+		this->slots.push_back(HandleSlot { 0, 0, false });
+	}
+	else
+	{
+		slot = this->freeSlots.back();
+		this->freeSlots.pop_back();
+	}
+
+	auto& handleSlot = this->slots[slot];
+	handleSlot.drawIndex = this->drawList.size();
+	handleSlot.isUsed = true;
+
+	this->drawList.push_back(item);
+	this->drawListSlots.push_back(slot);
+
+	return RenderHandle { slot, handleSlot.generation };
+}
+
+/// Tries to remove the renderable that is identified by
+/// the given handle from this game renderer.
+bool GameRenderer::remove(RenderHandle handle)
+{
+	if (!this->contains(handle))
+		return false;
+
+	auto& handleSlot = this->slots[handle.slot];
+	// Leave a tombstone in the draw list. It will be
+	// cleaned up later on. Renderables may be null, so
+	// tombstones are marked in the slot list.
+	this->drawList[handleSlot.drawIndex] = nullptr;
+	this->drawListSlots[handleSlot.drawIndex] = TombstoneSlot;
+	this->removedCount++;
+
+	handleSlot.isUsed = false;
+	handleSlot.generation++;
+	this->freeSlots.push_back(handle.slot);
+
+	// Compact the draw list once tombstones make up
+	// half of it. This keeps removal cheap, while making
+	// sure that the draw list doesn't grow without bound,
+	// even if the game is never rendered.
+	if (this->removedCount * 2 > this->drawList.size())
+		this->compact();
+
+	return true;
+}
+
+/// Tries to remove the given renderable from this game
+/// renderer.
+bool GameRenderer::remove(const IRenderable_ptr& item)
+{
+	if (item == nullptr)
+		return false;
+
+	auto pos = std::find(this->drawList.begin(), this->drawList.end(), item);
+	if (pos == this->drawList.end())
+		return false;
+
+	std::size_t slot = this->drawListSlots[pos - this->drawList.begin()];
+	return this->remove(RenderHandle { slot, this->slots[slot].generation });
+}
+
+/// Tests if the renderable that is identified by the
+/// given handle is currently in this game renderer.
+bool GameRenderer::contains(RenderHandle handle) const
+{
+	return handle.slot < this->slots.size()
+		&& this->slots[handle.slot].isUsed
+		&& this->slots[handle.slot].generation == handle.generation;
+}
+
+/// Tests if the given renderable is currently in this
+/// game renderer.
+bool GameRenderer::contains(const IRenderable_ptr& item) const
+{
+	return item != nullptr
+		&& std::find(this->drawList.begin(), this->drawList.end(), item) != this->drawList.end();
+}
+
+/// Gets the number of renderables in this game renderer.
+std::size_t GameRenderer::size() const
+{
+	return this->drawList.size() - this->removedCount;
+}
+
+/// Removes the tombstones that removed renderables
+/// have left in the draw list.
+void GameRenderer::compact()
+{
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < this->drawList.size(); i++)
+	{
+		std::size_t slot = this->drawListSlots[i];
+		if (slot != TombstoneSlot)
+		{
+			this->drawList[count] = std::move(this->drawList[i]);
+			this->drawListSlots[count] = slot;
+			this->slots[slot].drawIndex = count;
+			count++;
+		}
+	}
+	this->drawList.resize(count);
+	this->drawListSlots.resize(count);
+	this->removedCount = 0;
+}
+
 void GameRenderer::render(
 	RenderContext& target, DoubleRect bounds,
 	const Transformation& transform)
@@ -19,9 +139,10 @@ void GameRenderer::render(
 	target.getTarget().clear(backgroundColor);
 
 	// Then render the game by rendering all sub-objects.
-	for (const auto& item : this->items)
+	for (const auto& item : this->drawList)
 	{
-		item->render(target, bounds, transform);
+		if (item != nullptr)
+			item->render(target, bounds, transform);
 	}
 }
 
@@ -36,4 +157,4 @@ sf::Color GameRenderer::getBackgroundColor() const
 void GameRenderer::setBackgroundColor(sf::Color color)
 {
 	this->backgroundColor = color;
-}
\ No newline at end of file
+}
@@ -1,20 +1,61 @@
 #pragma once
 
+#include <cstddef>
+#include <vector>
 #include "IRenderable.h"
-#include "Container.h"
 #include "Transformation.h"
 
 namespace si
 {
 	namespace view
 	{
+		/// Identifies a renderable that has been added
+		/// to a game renderer.
+		struct RenderHandle
+		{
+			/// The index of the renderable's slot.
+			std::size_t slot;
+
+			/// The slot's generation at the time the renderable
+			/// was added. A slot's generation is incremented
+			/// whenever its renderable is removed, which makes
+			/// stale handles harmless.
+			std::size_t generation;
+		};
+
 		/// Defines a renderable game object.
-		class GameRenderer final : public Container<IRenderable>, public virtual IRenderable
+		/// Renderables are drawn in the order in which they were
+		/// added. They can be removed in constant time by handle.
+		class GameRenderer final : public virtual IRenderable
 		{
 		public:
 			/// Creates a game renderer with the given background color.
 			GameRenderer(sf::Color backgroundColor);
 
+			/// Adds the given renderable to this game renderer.
+			/// A handle is returned that identifies the renderable.
+			RenderHandle add(const IRenderable_ptr& item);
+
+			/// Tries to remove the renderable that is identified by
+			/// the given handle from this game renderer. If this cannot
+			/// be done, false is returned. Otherwise, true is returned.
+			bool remove(RenderHandle handle);
+
+			/// Tries to remove the given renderable from this game
+			/// renderer. Removing renderables by handle is faster.
+			bool remove(const IRenderable_ptr& item);
+
+			/// Tests if the renderable that is identified by the
+			/// given handle is currently in this game renderer.
+			bool contains(RenderHandle handle) const;
+
+			/// Tests if the given renderable is currently in this
+			/// game renderer. Testing by handle is faster.
+			bool contains(const IRenderable_ptr& item) const;
+
+			/// Gets the number of renderables in this game renderer.
+			std::size_t size() const;
+
 			/// Renders the entire game.
 			void render(
 				RenderContext& target, DoubleRect bounds,
@@ -28,8 +69,41 @@ namespace si
 			void setBackgroundColor(sf::Color color);
 
 		private:
+			/// Describes a slot, which maps a handle to
+			/// a position in the draw list.
+			struct HandleSlot
+			{
+				std::size_t drawIndex;
+				std::size_t generation;
+				bool isUsed;
+			};
+
+			/// Removes the tombstones that removed renderables
+			/// have left in the draw list.
+			void compact();
+
+			/// The renderables to draw, in draw order. Removed
+			/// renderables leave a tombstone behind, which is
+			/// cleaned up by compacting the draw list once enough
+			/// renderables have been removed.
+			std::vector<IRenderable_ptr> drawList;
+
+			/// The slot of each renderable in the draw list, or
+			/// the tombstone slot if the renderable was removed.
+			std::vector<std::size_t> drawListSlots;
+
+			/// The slot index that marks tombstones in the
+			/// draw list.
+			static const std::size_t TombstoneSlot;
+
+			std::vector<HandleSlot> slots;
+			std::vector<std::size_t> freeSlots;
+
+			/// The number of null pointers in the draw list.
+			std::size_t removedCount;
+
 			/// The game's background color.
 			sf::Color backgroundColor;
 		};
 	}
-}
\ No newline at end of file
+}
@@ -3,14 +3,13 @@
 #include <algorithm>
 #include <chrono>
 #include <cstddef>
-#include <deque>
 #include <functional>
-#include <tuple>
+#include <vector>
 #include <SFML/Graphics.hpp>
 #include "Common.h"
+#include "model/PathDescriptor.h"
 #include "IRenderable.h"
 #include "Transformation.h"
-#include "PathOffsetRenderable.h"
 #include "RandomGenerator.h"
 
 using namespace si;
@@ -27,7 +26,9 @@ ParticleEmitterRenderable::ParticleEmitterRenderable(
     duration_t particleInterval, duration_t particleLifetime)
     : factory(factory), particleSpeed(particleSpeed),
       particleInterval(particleInterval), particleLifetime(particleLifetime),
-      elapsedTime(0.0s), totalElapsedTime(0.0s), particles()
+      elapsedTime(0.0s), totalElapsedTime(0.0s), particles(),
+      particleCreationTimes(), particlePaths(),
+      particleAges(), particleOffsets(), particleDirections()
 { }
 
 /// Renders this renderable object on the
@@ -40,57 +41,70 @@ void ParticleEmitterRenderable::render(
 {
 	// Update elapsed time, particle list
 	this->updateTime(target.getTimeDelta());
-	// Create a new batch of particles
-	this->createParticles();
+	// Create a new batch of particles. Lower quality
+	// settings stretch the interval between particles.
+	const auto& quality = target.getQuality();
+	this->createParticles(this->particleInterval / quality.particleRate);
+
+	// Compute all particle offsets in one go.
+	std::size_t count = this->particles.size();
+	this->particleAges.resize(count);
+	this->particleOffsets.resize(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		this->particleAges[i] = (this->totalElapsedTime - this->particleCreationTimes[i]).count();
+	}
+	this->particlePaths.evaluate(this->particleAges.data(), this->particleOffsets.data());
 
-	for (const auto& item : this->particles)
+	for (std::size_t i = 0; i < count; i++)
     {
-        const auto& renderable = std::get<0>(item);
-        renderable->render(target, bounds, transform);
+        const auto& offset = this->particleOffsets[i];
+        DoubleRect innerBox(
+            bounds.left + bounds.width * offset.x,
+            bounds.top + bounds.height * offset.y,
+            bounds.width,
+            bounds.height);
+
+        if (quality.skipOffscreenEffects && target.isOffscreen(innerBox, transform))
+            continue;
+
+        this->particles[i]->render(target, innerBox, transform);
     }
 }
 
-/// Creates new particles, given rectangular
-/// bounds and a transformation. The amount of particles
-/// that are created depends on the amount of time that has passed
-/// since the last batch of particles was created.
-void ParticleEmitterRenderable::createParticles()
+/// Creates new particles at the given interval. The amount
+/// of particles that are created depends on the amount of time
+/// that has passed since the last batch of particles was created.
+void ParticleEmitterRenderable::createParticles(duration_t interval)
 {
-	if (this->elapsedTime > this->particleInterval)
+	if (this->elapsedTime > interval)
 	{
         // Compute the number of particles we can create.
-        double frac = this->elapsedTime / this->particleInterval;
+        double frac = this->elapsedTime / interval;
         int amount = static_cast<int>(frac);
         // Subtract the amount of time we "used up" by creating these particles
         // from the elapsed time.
-        duration_t rem = this->elapsedTime - amount * this->particleInterval;
+        duration_t rem = this->elapsedTime - amount * interval;
+
+        // Pick random directions for all new particles at once.
+        this->particleDirections.resize(2 * amount);
+        RandomGenerator::effects.fillReal(
+            this->particleDirections.data(), this->particleDirections.size(), -1.0, 1.0);
 
         for (int i = 0; i < amount; i++)
         {
             // Create a new particle.
             auto renderable = this->factory();
 
-            auto& rng = RandomGenerator::instance;
-
-            // Pick a random direction.
-            Vector2d dir(
-                rng.nextReal<double>(-1.0, 1.0),
-                rng.nextReal<double>(-1.0, 1.0));
+            Vector2d dir(this->particleDirections[2 * i], this->particleDirections[2 * i + 1]);
 
             // Normalize it, multiply it by the particle speed.
             Vector2d vel = this->particleSpeed * normalizeVec(dir);
-            duration_t currentTime = this->totalElapsedTime;
 
-            // This makes copying particle emitters impossible. Fortunately,
-            // the copy constructor has been deleted.
-            auto path = [this, vel, currentTime]() -> Vector2d
-            {
-                return (this->totalElapsedTime - currentTime).count() * vel;
-            };
-
-            auto pathRenderable = std::make_shared<PathOffsetRenderable>(renderable, path);
-
-            this->particles.push_back(std::make_tuple(pathRenderable, this->totalElapsedTime));
+            // The particle moves away from the emitter in a straight line.
+            this->particles.push_back(renderable);
+            this->particleCreationTimes.push_back(this->totalElapsedTime);
+            this->particlePaths.add(si::model::PathDescriptor::linear(Vector2d(), vel));
         }
 
 		// Set the elapsed time to the remaining time.
@@ -106,13 +120,22 @@ void ParticleEmitterRenderable::updateTime(duration_t delta)
 	this->totalElapsedTime += delta;
 	this->elapsedTime += delta;
 
-	auto totalTime = this->totalElapsedTime;
-	auto lifetime = this->particleLifetime;
+	// Remove old particles. All particles share the same
+	// lifetime, and they are ordered by creation time, so
+	// the particles that have timed out form a prefix of
+	// the particle list.
+	std::size_t expired = 0;
+	while (expired < this->particles.size()
+		&& this->totalElapsedTime - this->particleCreationTimes[expired] > this->particleLifetime)
+	{
+		expired++;
+	}
 
-	// Remove old particles.
-	this->particles.erase(std::remove_if(this->particles.begin(), this->particles.end(),
-		[=](const std::tuple<IRenderable_ptr, duration_t>& item) -> bool
-		{
-			return totalTime - std::get<1>(item) > lifetime;
-		}), this->particles.end());
+	if (expired > 0)
+	{
+		this->particles.erase(this->particles.begin(), this->particles.begin() + expired);
+		this->particleCreationTimes.erase(
+			this->particleCreationTimes.begin(), this->particleCreationTimes.begin() + expired);
+		this->particlePaths.erase(0, expired);
+	}
 }
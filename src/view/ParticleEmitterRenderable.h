@@ -1,14 +1,13 @@
 #pragma once
 
 #include <cstddef>
-#include <deque>
 #include <functional>
-#include <tuple>
+#include <vector>
 #include <SFML/Graphics.hpp>
 #include "Common.h"
+#include "model/PathDescriptor.h"
 #include "IRenderable.h"
 #include "Transformation.h"
-#include "PathOffsetRenderable.h"
 
 namespace si
 {
@@ -41,10 +40,10 @@ namespace si
 				RenderContext& target, DoubleRect bounds,
 				const Transformation& transform) final override;
 		private:
-			/// Creates new particles. The amount of particles
-            /// that are created depends on the amount of time that has passed
-            /// since the last batch of particles was created.
-			void createParticles();
+			/// Creates new particles at the given interval. The amount
+            /// of particles that are created depends on the amount of time
+            /// that has passed since the last batch of particles was created.
+			void createParticles(duration_t interval);
 
 			/// Updates the elapsed time, optionally removing timed
 			/// out particles.
@@ -56,7 +55,21 @@ namespace si
 			const duration_t particleLifetime;
 			duration_t elapsedTime;
 			duration_t totalElapsedTime;
-			std::deque<std::tuple<IRenderable_ptr, duration_t>> particles;
+
+			/// The particles' renderables, creation times and paths,
+			/// ordered by creation time. Particle paths are linear
+			/// path descriptors, which are evaluated in a single batch.
+			std::vector<IRenderable_ptr> particles;
+			std::vector<duration_t> particleCreationTimes;
+			si::model::PathBatch particlePaths;
+
+			/// Scratch buffers for path evaluation.
+			std::vector<double> particleAges;
+			std::vector<Vector2d> particleOffsets;
+
+			/// Scratch buffer for the random numbers that new
+			/// particles' directions are picked from.
+			std::vector<double> particleDirections;
 		};
 	}
 }
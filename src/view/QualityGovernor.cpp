@@ -0,0 +1,120 @@
+#include "QualityGovernor.h"
+
+#include <algorithm>
+#include <cstddef>
+#include "Common.h"
+#include "RenderContext.h"
+
+using namespace si;
+using namespace si::view;
+
+namespace
+{
+	/// The weight of the most recent frame time in
+	/// the moving average of frame times.
+	const double AverageWeight = 0.1;
+
+	/// The amount by which the quality level is
+	/// lowered when frames are over budget.
+	const double LowerStep = 0.1;
+
+	/// The amount by which the quality level is
+	/// raised when frames are well within budget.
+	const double RaiseStep = 0.025;
+
+	/// The fraction of the budget that frames must stay
+	/// under before the quality level is raised.
+	const double RaiseThreshold = 0.75;
+
+	/// The number of frames that the moving average needs
+	/// to catch up after the quality level has changed.
+	const std::size_t CooldownFrames = 20;
+}
+
+/// Creates a quality governor that tries to keep
+/// frame times within the given budget.
+QualityGovernor::QualityGovernor(duration_t frameBudget)
+	: frameBudget(frameBudget), averageFrameTime(0.0),
+	  level(1.0), minLevel(1.0), cooldown(CooldownFrames)
+{ }
+
+/// Gets the amount of time that a frame may take.
+duration_t QualityGovernor::getFrameBudget() const
+{
+	return this->frameBudget;
+}
+
+/// Sets the amount of time that a frame may take.
+void QualityGovernor::setFrameBudget(duration_t frameBudget)
+{
+	this->frameBudget = frameBudget;
+	this->cooldown = CooldownFrames;
+}
+
+/// Records the amount of time that a frame took,
+/// and adjusts the quality level if necessary.
+void QualityGovernor::addFrameTime(duration_t frameTime)
+{
+	if (this->averageFrameTime == 0.0)
+		// Seed the average with the first frame time.
+		this->averageFrameTime = frameTime.count();
+	else
+		this->averageFrameTime += AverageWeight * (frameTime.count() - this->averageFrameTime);
+
+	if (this->cooldown > 0)
+	{
+		this->cooldown--;
+		return;
+	}
+
+	double budget = this->frameBudget.count();
+	double newLevel = this->level;
+	if (this->averageFrameTime > budget)
+		newLevel = std::max(this->level - LowerStep, 0.0);
+	else if (this->averageFrameTime < RaiseThreshold * budget)
+		newLevel = std::min(this->level + RaiseStep, 1.0);
+
+	if (newLevel != this->level)
+	{
+		this->level = newLevel;
+		this->minLevel = std::min(this->minLevel, newLevel);
+		this->cooldown = CooldownFrames;
+	}
+}
+
+/// Gets the current quality level.
+double QualityGovernor::getLevel() const
+{
+	return this->level;
+}
+
+/// Gets the lowest quality level that this
+/// governor has used.
+double QualityGovernor::getMinLevel() const
+{
+	return this->minLevel;
+}
+
+/// Gets the quality settings that match the
+/// current quality level.
+QualitySettings QualityGovernor::getSettings() const
+{
+	return getSettings(this->level);
+}
+
+/// Gets the quality settings that match the
+/// given quality level.
+QualitySettings QualityGovernor::getSettings(double level)
+{
+	QualitySettings result;
+	// Particles and ribbon points are never thinned out
+	// entirely, so effects remain recognizable.
+	result.particleRate = 0.25 + 0.75 * level;
+	result.ribbonDetail = 0.25 + 0.75 * level;
+	result.ribbonLifetime = 0.5 + 0.5 * level;
+	// Below half quality, animations run at 15 frames
+	// per second.
+	result.animationInterval = duration_t(level < 0.5 ? 1.0 / 15.0 : 0.0);
+	result.skipOffscreenEffects = level < 1.0;
+	return result;
+}
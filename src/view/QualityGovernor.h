@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include "Common.h"
+#include "RenderContext.h"
+
+namespace si
+{
+	namespace view
+	{
+		/// Defines a quality governor, which watches how long
+		/// frames take, and lowers or raises the quality of visual
+		/// effects to keep frame times within a budget.
+		///
+		/// Quality is described by a single level in the range
+		/// [0, 1], which is mapped to a set of quality settings.
+		/// The level is lowered quickly when frames are over
+		/// budget, and raised slowly when there is plenty of
+		/// room, so it doesn't oscillate.
+		class QualityGovernor final
+		{
+		public:
+			/// Creates a quality governor that tries to keep
+			/// frame times within the given budget.
+			QualityGovernor(duration_t frameBudget);
+
+			/// Gets the amount of time that a frame may take.
+			duration_t getFrameBudget() const;
+
+			/// Sets the amount of time that a frame may take.
+			void setFrameBudget(duration_t frameBudget);
+
+			/// Records the amount of time that a frame took,
+			/// and adjusts the quality level if necessary.
+			void addFrameTime(duration_t frameTime);
+
+			/// Gets the current quality level, in the
+			/// range [0, 1].
+			double getLevel() const;
+
+			/// Gets the lowest quality level that this
+			/// governor has used.
+			double getMinLevel() const;
+
+			/// Gets the quality settings that match the
+			/// current quality level.
+			QualitySettings getSettings() const;
+
+			/// Gets the quality settings that match the
+			/// given quality level.
+			static QualitySettings getSettings(double level);
+
+		private:
+			duration_t frameBudget;
+			/// An exponential moving average of recent
+			/// frame times.
+			double averageFrameTime;
+			double level;
+			double minLevel;
+			/// The number of frames that have to pass before
+			/// the quality level may change again.
+			std::size_t cooldown;
+		};
+	}
+}
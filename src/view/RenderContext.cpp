@@ -1,12 +1,22 @@
 #include "RenderContext.h"
 
+#include <algorithm>
 #include <SFML/Graphics.hpp>
+#include "Transformation.h"
 
 using namespace si;
 using namespace si::view;
 
 RenderContext::RenderContext(sf::RenderTarget& target, duration_t timeDelta)
-	: target(target), timeDelta(timeDelta)
+	: target(target), timeDelta(timeDelta), quality()
+{ }
+
+/// Creates a new render context from the given
+/// render target and quality settings.
+RenderContext::RenderContext(
+	sf::RenderTarget& target, duration_t timeDelta,
+	const QualitySettings& quality)
+	: target(target), timeDelta(timeDelta), quality(quality)
 { }
 
 sf::RenderTarget& RenderContext::getTarget()
@@ -14,6 +24,13 @@ sf::RenderTarget& RenderContext::getTarget()
 	return this->target;
 }
 
+/// Gets the quality settings that renderables
+/// should use.
+const QualitySettings& RenderContext::getQuality() const
+{
+	return this->quality;
+}
+
 Vector2d RenderContext::transformView(Vector2d vec) const
 {
 	Vector2d size(this->target.getSize());
@@ -39,6 +56,32 @@ DoubleRect RenderContext::getBounds() const
 	return DoubleRect(pos, size);
 }
 
+/// Tests if the given bounds, in absolute coordinates,
+/// are entirely outside of this render context's bounds
+/// once the given transformation has been applied.
+bool RenderContext::isOffscreen(DoubleRect bounds, const Transformation& transform) const
+{
+	// Find the bounding box of the transformed bounds.
+	Vector2d corners[] =
+	{
+		transform.transformPoint(Vector2d(bounds.left, bounds.top)),
+		transform.transformPoint(Vector2d(bounds.left + bounds.width, bounds.top)),
+		transform.transformPoint(Vector2d(bounds.left, bounds.top + bounds.height)),
+		transform.transformPoint(Vector2d(bounds.left + bounds.width, bounds.top + bounds.height))
+	};
+	Vector2d minPos = corners[0];
+	Vector2d maxPos = corners[0];
+	for (const auto& item : corners)
+	{
+		minPos = Vector2d(std::min(minPos.x, item.x), std::min(minPos.y, item.y));
+		maxPos = Vector2d(std::max(maxPos.x, item.x), std::max(maxPos.y, item.y));
+	}
+
+	auto screen = this->getBounds();
+	return maxPos.x < screen.left || minPos.x > screen.left + screen.width
+		|| maxPos.y < screen.top || minPos.y > screen.top + screen.height;
+}
+
 duration_t RenderContext::getTimeDelta() const
 {
 	return this->timeDelta;
@@ -2,11 +2,40 @@
 
 #include <SFML/Graphics.hpp>
 #include "Common.h"
+#include "Transformation.h"
 
 namespace si
 {
 	namespace view
 	{
+		/// Defines a number of knobs that trade the quality of
+		/// visual effects for rendering speed.
+		struct QualitySettings
+		{
+			/// Creates a set of quality settings that renders
+			/// everything at full quality.
+			QualitySettings()
+				: particleRate(1.0), ribbonDetail(1.0), ribbonLifetime(1.0),
+				  animationInterval(0.0), skipOffscreenEffects(false)
+			{ }
+
+			/// The fraction of particles that particle emitters
+			/// emit, in the range (0, 1].
+			double particleRate;
+			/// The fraction of points that ribbons log, in the
+			/// range (0, 1]. Ribbons with fewer points are coarser.
+			double ribbonDetail;
+			/// The fraction of the ribbons' point lifetime that
+			/// points are kept for, in the range (0, 1].
+			double ribbonLifetime;
+			/// The minimal amount of time between two updates
+			/// of an animation's frame.
+			duration_t animationInterval;
+			/// Tells if effects that are outside of the render
+			/// target's bounds are not drawn.
+			bool skipOffscreenEffects;
+		};
+
 		/// Encapsulates a render target,
 		/// and provides helper functionality.
 		class RenderContext
@@ -16,9 +45,19 @@ namespace si
 			/// render target.
 			RenderContext(sf::RenderTarget& target, duration_t timeDelta);
 
+			/// Creates a new render context from the given
+			/// render target and quality settings.
+			RenderContext(
+				sf::RenderTarget& target, duration_t timeDelta,
+				const QualitySettings& quality);
+
 			/// Gets this render context's render target.
 			sf::RenderTarget& getTarget();
 
+			/// Gets the quality settings that renderables
+			/// should use.
+			const QualitySettings& getQuality() const;
+
 			/// Applies a viewport transformation to
 			/// the given scalar by multiplying it
 			/// with the geometric mean of the viewport
@@ -44,12 +83,18 @@ namespace si
 			/// absolute screen coordinates.
 			DoubleRect getBounds() const;
 
+			/// Tests if the given bounds, in absolute coordinates,
+			/// are entirely outside of this render context's bounds
+			/// once the given transformation has been applied.
+			bool isOffscreen(DoubleRect bounds, const Transformation& transform) const;
+
 			/// Gets the amount of time elapsed since
 			/// the last frame was rendered.
 			duration_t getTimeDelta() const;
 		private:
 			sf::RenderTarget& target;
 			duration_t timeDelta;
+			QualitySettings quality;
 		};
 	}
 }
\ No newline at end of file
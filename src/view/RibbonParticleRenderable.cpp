@@ -8,12 +8,42 @@
 #include <SFML/Graphics.hpp>
 #include "Common.h"
 #include "IRenderable.h"
+#include "RenderContext.h"
 #include "Transformation.h"
 
 using namespace si;
 using namespace si::view;
 using namespace std::chrono_literals;
 
+namespace
+{
+	/// Tests if the ribbon segment between the given pairs of
+	/// polygon points is entirely outside of the given render
+	/// context's bounds.
+	bool isOffscreenSegment(
+		const RenderContext& target,
+		const std::tuple<Vector2d, Vector2d>& first,
+		const std::tuple<Vector2d, Vector2d>& second)
+	{
+		Vector2d points[] =
+		{
+			std::get<0>(first), std::get<1>(first),
+			std::get<0>(second), std::get<1>(second)
+		};
+		Vector2d minPos = points[0];
+		Vector2d maxPos = points[0];
+		for (const auto& item : points)
+		{
+			minPos = Vector2d(std::min(minPos.x, item.x), std::min(minPos.y, item.y));
+			maxPos = Vector2d(std::max(maxPos.x, item.x), std::max(maxPos.y, item.y));
+		}
+
+		// Ribbon points are stored in absolute coordinates, so
+		// they don't have to be transformed again.
+		return target.isOffscreen(DoubleRect(minPos, maxPos - minPos), Transformation::identity);
+	}
+}
+
 /// Creates a new ribbon particle renderable from the
 /// given color, a duration that represents the interval 
 /// at which new points are logged, and a duration
@@ -34,10 +64,12 @@ void RibbonParticleRenderable::render(
 	RenderContext& target, DoubleRect bounds,
 	const Transformation& transform)
 {
-	// Update elapsed time, previous position list
-	this->updateTime(target.getTimeDelta());
+	// Update elapsed time, previous position list. Lower
+	// quality settings make ribbons shorter and coarser.
+	const auto& quality = target.getQuality();
+	this->updateTime(target.getTimeDelta(), this->pointLifetime * quality.ribbonLifetime);
 	// Log current position.
-	this->logPosition(bounds, transform);
+	this->logPosition(bounds, transform, this->pointInterval / quality.ribbonDetail);
 
 	if (this->prevPositions.size() > 1)
 	{
@@ -47,6 +79,12 @@ void RibbonParticleRenderable::render(
 		{
 			auto curPts = getPositions(i);
 
+			if (quality.skipOffscreenEffects && isOffscreenSegment(target, prevPts, curPts))
+			{
+				prevPts = curPts;
+				continue;
+			}
+
 			// Fade segments as they get older.
 			double alpha = 1.0 - (this->totalElapsedTime - std::get<2>(this->prevPositions.at(i))) / totalLifetime;
 
@@ -69,11 +107,13 @@ void RibbonParticleRenderable::render(
 }
 
 /// Logs the current position, given rectangular
-/// bounds.
+/// bounds, if at least the given interval has passed
+/// since the previous position was logged.
 void RibbonParticleRenderable::logPosition(
-	DoubleRect bounds, const Transformation& transform)
+	DoubleRect bounds, const Transformation& transform,
+	duration_t interval)
 {
-	if (this->elapsedTime > this->pointInterval)
+	if (this->elapsedTime > interval)
 	{
 		// The current position is the position in the middle
 		// of the current bounding rectangle.
@@ -92,16 +132,15 @@ void RibbonParticleRenderable::logPosition(
 	}
 }
 
-/// Updates the elapsed time, optionally removing timed
-/// out previous positions.
-void RibbonParticleRenderable::updateTime(duration_t delta)
+/// Updates the elapsed time, removing previous positions
+/// that are older than the given lifetime.
+void RibbonParticleRenderable::updateTime(duration_t delta, duration_t lifetime)
 {
 	// Update the (total) elapsed time.
 	this->totalElapsedTime += delta;
 	this->elapsedTime += delta;
 
 	auto totalTime = this->totalElapsedTime;
-	auto lifetime = this->pointLifetime;
 
 	// Remove old points.
 	this->prevPositions.erase(std::remove_if(this->prevPositions.begin(), this->prevPositions.end(),
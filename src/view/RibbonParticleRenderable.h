@@ -34,12 +34,16 @@ namespace si
 				const Transformation& transform) final override;
 		private:
 			/// Logs the current position, given rectangular
-			/// bounds and a transformation.
-			void logPosition(DoubleRect bounds, const Transformation& transform);
+			/// bounds and a transformation, if at least the given
+			/// interval has passed since the previous position
+			/// was logged.
+			void logPosition(
+				DoubleRect bounds, const Transformation& transform,
+				duration_t interval);
 
-			/// Updates the elapsed time, optionally removing timed
-			/// out previous positions.
-			void updateTime(duration_t delta);
+			/// Updates the elapsed time, removing previous positions
+			/// that are older than the given lifetime.
+			void updateTime(duration_t delta, duration_t lifetime);
 
 			/// Gets the polygon points for the position at
 			/// the given index. The deque of points
@@ -21,7 +21,14 @@ void SpriteRenderableBase::render(
 {
 	sf::Sprite sprite(*this->texture);
 	sprite.setPosition(static_cast<float>(bounds.left), static_cast<float>(bounds.top));
-	auto textureRect = this->getTextureRectangle(context.getTimeDelta());
+	auto textureRect = this->getTextureRectangle(context);
+	if (textureRect.width <= 0 || textureRect.height <= 0)
+	{
+		// The texture is empty, most likely because it is
+		// still being loaded. Don't draw anything.
+		return;
+	}
+
 	sprite.setTextureRect(textureRect);
 	sprite.setScale(static_cast<float>(bounds.width) / textureRect.width, static_cast<float>(bounds.height) / textureRect.height);
 	context.getTarget().draw(sprite, transform.toRenderState());
@@ -39,7 +46,7 @@ SpriteRenderable::SpriteRenderable(
 { }
 
 /// Gets the rectangular area of the texture to render.
-sf::IntRect SpriteRenderable::getTextureRectangle(duration_t)
+sf::IntRect SpriteRenderable::getTextureRectangle(const RenderContext&)
 {
 	auto textureSize = this->getTexture()->getSize();
 	return{ 0, 0, static_cast<int>(textureSize.x), static_cast<int>(textureSize.y) };